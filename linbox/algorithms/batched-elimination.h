@@ -0,0 +1,255 @@
+/* linbox/algorithms/batched-elimination.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/batched-elimination.h
+ * @ingroup algorithms
+ * @brief Determinants and ranks of a batch of small dense matrices.
+ *
+ * The matrices are given as one contiguous stack: matrix \c b is the
+ * row major \f$m\times m\f$ array starting at \c A+b*stride. They are
+ * all over the same field, or each over its own prime field.
+ *
+ * Below \c LINBOX_BATCHED_ELIMINATION_SIMD_DIM, the matrices are
+ * interleaved by groups of \c LINBOX_BATCHED_ELIMINATION_LANES, entry
+ * \f$(i,j)\f$ of the matrices of a group being contiguous, and one
+ * Gaussian elimination is run on the whole group: the loops over the
+ * matrices are the innermost ones, and vectorise. Pivots differ between
+ * matrices, so no rows are swapped: the pivot row of each column is
+ * recorded per matrix, and the sign of the determinant is recovered from
+ * these pivot rows at the end. Larger matrices are handed to FFPACK one
+ * by one. In both cases, groups or matrices are shared between threads.
+ */
+
+#ifndef __LINBOX_batched_elimination_H
+#define __LINBOX_batched_elimination_H
+
+#include <vector>
+#include <algorithm>
+
+#include <fflas-ffpack/ffpack/ffpack.h>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+
+#ifndef LINBOX_BATCHED_ELIMINATION_SIMD_DIM
+// largest dimension for which the matrices are interleaved
+#define LINBOX_BATCHED_ELIMINATION_SIMD_DIM 16
+#endif
+
+#ifndef LINBOX_BATCHED_ELIMINATION_LANES
+// number of interleaved matrices
+#define LINBOX_BATCHED_ELIMINATION_LANES 32
+#endif
+
+namespace LinBox
+{
+
+	/** \brief Determinants and ranks of many small matrices at once.
+	 * \ingroup algorithms
+	 *
+	 * The input stack is overwritten.
+	 */
+	template<class Field_>
+	class BatchedEliminationDomain {
+	public:
+		typedef Field_                     Field;
+		typedef typename Field::Element  Element;
+
+		BatchedEliminationDomain (const Field& F) :
+			_field(&F)
+		{}
+
+		const Field& field () const { return *_field; }
+
+		/// dets[b] = determinant of the b-th matrix of the stack, for b < count
+		std::vector<Element>& det (std::vector<Element>& dets, Element* A, size_t m, size_t count, size_t stride = 0) const
+		{
+			std::vector<size_t> ranks;
+			_run(SingleField(field()), &dets, ranks, A, m, count, stride);
+			return dets;
+		}
+
+		/// ranks[b] = rank of the b-th matrix of the stack, for b < count
+		std::vector<size_t>& rank (std::vector<size_t>& ranks, Element* A, size_t m, size_t count, size_t stride = 0) const
+		{
+			_run(SingleField(field()), (std::vector<Element>*)0, ranks, A, m, count, stride);
+			return ranks;
+		}
+
+		/// dets[b] = determinant of the b-th matrix of the stack over \p fields[b]
+		static std::vector<Element>& det (std::vector<Element>& dets, const std::vector<Field>& fields,
+						  Element* A, size_t m, size_t stride = 0)
+		{
+			std::vector<size_t> ranks;
+			_run(LaneFields(fields), &dets, ranks, A, m, fields.size(), stride);
+			return dets;
+		}
+
+		/// ranks[b] = rank of the b-th matrix of the stack over \p fields[b]
+		static std::vector<size_t>& rank (std::vector<size_t>& ranks, const std::vector<Field>& fields,
+						  Element* A, size_t m, size_t stride = 0)
+		{
+			_run(LaneFields(fields), (std::vector<Element>*)0, ranks, A, m, fields.size(), stride);
+			return ranks;
+		}
+
+	protected:
+		const Field *_field;
+
+		// field of the b-th matrix
+		struct SingleField {
+			const Field& F;
+			SingleField (const Field& f) : F(f) {}
+			const Field& operator() (size_t) const { return F; }
+		};
+
+		struct LaneFields {
+			const std::vector<Field>& F;
+			LaneFields (const std::vector<Field>& f) : F(f) {}
+			const Field& operator() (size_t b) const { return F[b]; }
+		};
+
+		template<class FieldOf>
+		static void _run (const FieldOf& FO, std::vector<Element>* dets, std::vector<size_t>& ranks,
+				  Element* A, size_t m, size_t count, size_t stride)
+		{
+			if (stride == 0) stride = m*m;
+			linbox_check(stride >= m*m);
+			if (dets) dets->resize(count);
+			ranks.resize(count);
+			if (count == 0) return;
+			if (m == 0) {
+				for (size_t b = 0; b < count; ++b) {
+					if (dets) (*dets)[b] = FO(b).one;
+					ranks[b] = 0;
+				}
+				return;
+			}
+
+			if (m <= LINBOX_BATCHED_ELIMINATION_SIMD_DIM) {
+				const size_t L = LINBOX_BATCHED_ELIMINATION_LANES;
+				const long groups = (long)((count + L - 1) / L);
+#pragma omp parallel for schedule(dynamic)
+				for (long g = 0; g < groups; ++g) {
+					size_t b0 = (size_t)g*L;
+					_interleaved(FO, dets, ranks, A, m, stride, b0, std::min(L, count - b0));
+				}
+			}
+			else {
+#pragma omp parallel for schedule(dynamic)
+				for (long b = 0; b < (long)count; ++b) {
+					const Field& F = FO((size_t)b);
+					Element* Ab = A + (size_t)b*stride;
+					if (dets)
+						FFPACK::Det(F, (*dets)[(size_t)b], m, Ab, m);
+					else
+						ranks[(size_t)b] = FFPACK::Rank(F, m, m, Ab, m);
+				}
+			}
+		}
+
+		// Gaussian elimination on the matrices b0 .. b0+L-1, interleaved
+		template<class FieldOf>
+		static void _interleaved (const FieldOf& FO, std::vector<Element>* dets, std::vector<size_t>& ranks,
+					  const Element* A, size_t m, size_t stride, size_t b0, size_t L)
+		{
+			std::vector<Element> W(m*m*L);
+			std::vector<Element> inv(L), fac(L), d(L);
+			std::vector<size_t> piv(m*L), pr(L), r(L, 0);
+			std::vector<char> used(m*L, 0), found(L);
+
+			for (size_t l = 0; l < L; ++l) {
+				const Element* Ab = A + (b0+l)*stride;
+				for (size_t ij = 0; ij < m*m; ++ij)
+					W[ij*L+l] = Ab[ij];
+				d[l] = FO(b0+l).one;
+			}
+
+			for (size_t k = 0; k < m; ++k) {
+				// pivot of column k: first nonzero entry in a row not used yet
+				for (size_t l = 0; l < L; ++l) {
+					const Field& F = FO(b0+l);
+					size_t i = 0;
+					while (i < m && (used[i*L+l] || F.isZero(W[(i*m+k)*L+l]))) ++i;
+					found[l] = (i < m);
+					piv[k*L+l] = i;
+					if (found[l]) {
+						used[i*L+l] = 1;
+						++r[l];
+						F.mulin(d[l], W[(i*m+k)*L+l]);
+						F.inv(inv[l], W[(i*m+k)*L+l]);
+						pr[l] = i;
+					}
+					else {
+						F.assign(d[l], F.zero);
+						F.assign(inv[l], F.zero);
+						pr[l] = 0;
+					}
+				}
+
+				// rows not used yet: row_i -= (a_ik / a_pk) row_p
+				for (size_t i = 0; i < m; ++i) {
+					for (size_t l = 0; l < L; ++l) {
+						const Field& F = FO(b0+l);
+						if (used[i*L+l])
+							F.assign(fac[l], F.zero);
+						else
+							F.mul(fac[l], W[(i*m+k)*L+l], inv[l]);
+					}
+					for (size_t j = k+1; j < m; ++j) {
+						Element* wi = &W[(i*m+j)*L];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+						for (size_t l = 0; l < L; ++l)
+							FO(b0+l).maxpyin(wi[l], fac[l], W[(pr[l]*m+j)*L+l]);
+					}
+				}
+			}
+
+			for (size_t l = 0; l < L; ++l) {
+				ranks[b0+l] = r[l];
+				if (!dets) continue;
+				// sign of the permutation column k -> pivot row of column k
+				if (r[l] == m) {
+					bool odd = false;
+					for (size_t k = 0; k < m; ++k)
+						for (size_t k2 = k+1; k2 < m; ++k2)
+							if (piv[k*L+l] > piv[k2*L+l]) odd = !odd;
+					if (odd) FO(b0+l).negin(d[l]);
+				}
+				(*dets)[b0+l] = d[l];
+			}
+		}
+	};
+
+}
+
+#endif // __LINBOX_batched_elimination_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -41,6 +41,7 @@
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
 #include "linbox/blackbox/archetype.h"
+#include "linbox/blackbox/apply-workspace.h"
 #include "linbox/blackbox/blockbb.h"
 #include "linbox/matrix/sparse-matrix.h"
 #include "linbox/matrix/dense-matrix.h"
@@ -72,9 +73,10 @@ public:
 
 		typename Block::ColIterator        p1 = M1.colBegin();
 		typename Block::ConstColIterator   p3 = M3.colBegin();
+		std::vector<typename Field::Element> z;
 
 		for (; p3 != M3.colEnd(); ++p1,++p3) {
-			M2.apply(*p1,*p3);
+			blackboxApply(*p1, M2, *p3, z);
 		}
 	}
 };
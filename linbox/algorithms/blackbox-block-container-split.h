@@ -0,0 +1,199 @@
+/* linbox/algorithms/blackbox-block-container-split.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/blackbox-block-container-split.h
+ * @ingroup algorithms
+ * @brief Block Wiedemann sequence computed column by column in parallel.
+ *
+ * The columns \f$V_j\f$ of the right projection are independent until
+ * the matrix generator step: the sequence \f$U A^i V_j\f$ of each column
+ * is computed by its own worker (Kaltofen's coarse grain parallelism).
+ * Columns are dealt round-robin to the MPI ranks of a Communicator,
+ * then to the OpenMP threads of each rank. The partial sequences are
+ * merged and the result is a container usable as is by
+ * BlockCoppersmithDomain or BlockMasseyDomain.
+ */
+
+#ifndef __LINBOX_blackbox_block_container_split_H
+#define __LINBOX_blackbox_block_container_split_H
+
+#include <algorithm>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/mpicpp.h"
+#include "linbox/algorithms/blackbox-block-container-base.h"
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/matrix-domain.h"
+
+namespace LinBox
+{
+
+	/*! @brief Block sequence \f$U A^i V\f$ computed by independent column workers.
+	 *
+	 * The whole sequence is computed at construction and then replayed by
+	 * the iterator. Every worker shares the blackbox, whose \c apply must
+	 * therefore be reentrant. When a Communicator with several ranks is
+	 * given, every rank must build the container collectively, with the
+	 * same projections, and all of them end up with the full sequence.
+	 */
+	template<class _Field, class _Blackbox, class _MatrixDomain = MatrixDomain<_Field>>
+	class BlackboxBlockContainerSplit : public BlackboxBlockContainerBase<_Field,_Blackbox,_MatrixDomain> {
+
+	public:
+		typedef _Field                        Field;
+		typedef typename Field::Element     Element;
+		typedef BlasMatrix<Field>           Block;
+		typedef BlasMatrix<Field>           Value;
+
+		/*! Constructor of the sequence from a blackbox, a field and two blocks projection.
+		 * @param C        communicator sharing the columns between ranks, or \c NULL
+		 * @param nthreads number of threads per rank, 0 for the OpenMP default
+		 */
+		BlackboxBlockContainerSplit(const _Blackbox *D, const Field &F, const Block &U0, const Block& V0,
+					    Communicator* C = NULL, size_t nthreads = 0) :
+			BlackboxBlockContainerBase<Field,_Blackbox,_MatrixDomain> (D, F, U0.rowdim(), V0.coldim())
+			, _iter(1), _comm(C), _nthreads(nthreads)
+		{
+			this->init (U0, V0);
+			_rep = std::vector<Value> (this->_size, Value(F, this->_m, this->_n));
+			_record();
+			this->_value = _rep[0];
+		}
+
+		const std::vector<Value>& getRep() const { return _rep; }
+
+	protected:
+		std::vector<Value>            _rep;
+		size_t                       _iter;
+		Communicator                *_comm;
+		size_t                   _nthreads;
+
+		// Sequence of column j: U A^i V_j for all i, in seq[i*m..(i+1)*m)
+		void _record_column(size_t j, std::vector<Element>& seq)
+		{
+			const Field& F = this->field();
+			MatrixDomain<Field> MD(F);
+			std::vector<Element> v(this->_nn), w(this->_nn), uv(this->_m), z;
+			for (size_t k = 0; k < this->_nn; ++k)
+				F.assign(v[k], this->_blockV.getEntry(k, j));
+
+			seq.resize(this->_size * this->_m);
+			for (size_t i = 0; i < this->_size; ++i) {
+				MD.vectorMul(uv, this->_blockU, v);
+				std::copy(uv.begin(), uv.end(), seq.begin() + (ptrdiff_t)(i * this->_m));
+				if (i+1 < this->_size) {
+					blackboxApply(w, *this->_BB, v, z);
+					std::swap(v, w);
+				}
+			}
+		}
+
+		void _record()
+		{
+			const size_t nranks = _comm ? (size_t)_comm->size() : 1;
+			const size_t rank   = _comm ? (size_t)_comm->rank() : 0;
+
+			std::vector<size_t> mine;
+			for (size_t j = rank; j < this->_n; j += nranks)
+				mine.push_back(j);
+
+			// each column in its own buffer, scattered into the blocks afterwards
+			std::vector<std::vector<Element> > seqs(mine.size());
+#ifdef _OPENMP
+			int nthreads = _nthreads ? (int)_nthreads : omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+			for (size_t c = 0; c < mine.size(); ++c)
+				_record_column(mine[c], seqs[c]);
+
+			for (size_t c = 0; c < mine.size(); ++c)
+				for (size_t i = 0; i < this->_size; ++i)
+					for (size_t k = 0; k < this->_m; ++k)
+						_rep[i].setEntry(k, mine[c], seqs[c][i*this->_m+k]);
+
+			if (nranks > 1)
+				_merge(nranks, rank);
+		}
+
+		// Gathers the columns on the master, then broadcasts the whole sequence.
+		// Sequences are packed as (_size * m) x n matrices.
+		void _merge(size_t nranks, size_t rank)
+		{
+			const Field& F = this->field();
+			const size_t m = this->_m, n = this->_n;
+
+			Block All(F, this->_size*m, n);
+			if (rank != 0) {
+				size_t nmine = (n > rank) ? (n - rank + nranks - 1) / nranks : 0;
+				Block Part(F, this->_size*m, nmine);
+				for (size_t c = 0, j = rank; j < n; ++c, j += nranks)
+					for (size_t i = 0; i < this->_size; ++i)
+						for (size_t k = 0; k < m; ++k)
+							Part.setEntry(i*m+k, c, _rep[i].getEntry(k, j));
+				_comm->send(Part, 0);
+			}
+			else {
+				for (size_t i = 0; i < this->_size; ++i)
+					for (size_t k = 0; k < m; ++k)
+						for (size_t j = 0; j < n; j += nranks)
+							All.setEntry(i*m+k, j, _rep[i].getEntry(k, j));
+				for (size_t r = 1; r < nranks; ++r) {
+					Block Part(F);
+					_comm->recv(Part, (int)r);
+					for (size_t c = 0, j = r; j < n; ++c, j += nranks)
+						for (size_t i = 0; i < this->_size; ++i)
+							for (size_t k = 0; k < m; ++k)
+								All.setEntry(i*m+k, j, Part.getEntry(i*m+k, c));
+				}
+			}
+
+			_comm->bcast(All, 0);
+			for (size_t i = 0; i < this->_size; ++i)
+				for (size_t k = 0; k < m; ++k)
+					for (size_t j = 0; j < n; ++j)
+						_rep[i].setEntry(k, j, All.getEntry(i*m+k, j));
+		}
+
+		// launcher which be used as iterator on the sequence
+		void _launch()
+		{
+			if (_iter < this->_size)
+				this->_value = _rep[_iter];
+			++_iter;
+		}
+
+		void _wait () {}
+	};
+
+}
+
+#endif // __LINBOX_blackbox_block_container_split_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
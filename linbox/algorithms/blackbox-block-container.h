@@ -32,10 +32,15 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/util/commentator.h"
 
 #include "linbox/algorithms/blackbox-block-container-base.h"
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/matrix/matrix-domain.h"
+#include "linbox/util/serialization.h"
+
+#include <cstdio>
+#include <string>
 
 #define _BBC_TIMING
 
@@ -257,6 +262,53 @@ namespace LinBox
 		}
 
 
+		/*! Constructor of the sequence from a blackbox, a field and two blocks projection,
+		 * recording on several threads with periodic checkpoints.
+		 *
+		 * At each step the projection \f$U A^i V\f$ is computed while the
+		 * columns of \f$A^{i+1} V\f$ are applied concurrently, so the
+		 * blackbox \c apply must be reentrant.
+		 * Every \p period steps, the recorded sequence and the current
+		 * block are written to \p checkpoint, with a fingerprint of the
+		 * blackbox (a hash of its product by the first column of \p V0).
+		 * If \p checkpoint already holds a state for the same blackbox and
+		 * projections, recording resumes from it. The file is removed once
+		 * the sequence is complete.
+		 * @param checkpoint file name, empty for no checkpoint
+		 * @param period     number of steps between two checkpoints
+		 * @param nthreads   number of threads, 0 for the OpenMP default
+		 */
+		BlackboxBlockContainerRecord(const _Blackbox *D, const Field &F, const Block &U0, const Block& V0,
+					     const std::string& checkpoint, size_t period = 64, size_t nthreads = 0) :
+			BlackboxBlockContainerBase<Field,_Blackbox,_MatrixDomain> (D, F,U0.rowdim(), V0.coldim())
+			, _blockW(F,D->rowdim(), V0.coldim()), _BMD(F),  _launcher(Nothing), _iter(1)
+			, _checkpoint(checkpoint), _fingerprint(0), _period(std::max(period,(size_t)1)), _nthreads(nthreads)
+		{
+#ifdef _BBC_TIMING
+			clearTimer();
+			tSequence.clear();
+			tSequence.start();
+#endif
+			this->init (U0, V0);
+			_rep = std::vector<Value> (this->_size, Value(F));
+			_Vcopy = this->_blockV;
+
+			size_t start = 0;
+			if (! _checkpoint.empty()) {
+				_fingerprint = _probe();
+				start = _load_checkpoint();
+			}
+			_record(start);
+			if (! _checkpoint.empty())
+				std::remove(_checkpoint.c_str());
+
+			this->_value=_rep[0];
+#ifdef _BBC_TIMING
+			tSequence.stop();
+			ttSequence += tSequence;
+#endif
+		}
+
 		void setU (const std::vector<Element> &b, size_t k)
 		{
 			linbox_check( b.size() == this->_row);
@@ -379,14 +431,160 @@ namespace LinBox
 		size_t                    _upd_idx;
 		std::vector<Element>            _u;
 		std::vector<Element>            _w;
+		std::vector<Element>            _z; // workspace of the applies
 		Launcher                 _launcher;
 		size_t                       _iter;
 		size_t                       _case;
 		std::vector<std::vector<Element> > _Special_U;
+		std::string            _checkpoint;
+		uint64_t              _fingerprint;
+		size_t                     _period;
+		size_t                   _nthreads;
 #ifdef _BBC_TIMING
 		Timer        ttSequence, tSequence;
 #endif
 
+		// Block blackboxes apply to the whole block at once
+		template<class BB>
+		typename std::enable_if<is_blockbb<BB>::value>::type
+		_apply_columns(Block& W, const BB& A, const Block& V)
+		{
+			this->Mul(W, A, V);
+		}
+
+		// otherwise one task per column of the block
+		template<class BB>
+		typename std::enable_if<!is_blockbb<BB>::value>::type
+		_apply_columns(Block& W, const BB& A, const Block& V)
+		{
+			const BB* Ap = &A;
+			typename Block::ColIterator        p1 = W.colBegin();
+			typename Block::ConstColIterator   p3 = V.colBegin();
+			for (; p3 != V.colEnd(); ++p1,++p3) {
+#ifdef _OPENMP
+#pragma omp task firstprivate(p1,p3,Ap)
+#endif
+				Ap->apply(*p1,*p3);
+			}
+		}
+
+		// Records _rep[start.._size-1], the current block being A^start V
+		void _record(size_t start)
+		{
+#ifdef _OPENMP
+			size_t nthreads = _nthreads ? _nthreads : (size_t)omp_get_max_threads();
+#endif
+			for (size_t i = start; i < this->_size; ++i) {
+				Block& cur  = this->casenumber ? this->_blockV : _blockW;
+				Block& next = this->casenumber ? _blockW : this->_blockV;
+				_rep[i].resize(this->_m, this->_n);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#pragma omp single
+#endif
+				{
+					// projection of the current block, ahead of the next one
+#ifdef _OPENMP
+#pragma omp task
+#endif
+					_BMD.mul(_rep[i], this->_blockU, cur);
+					if (i+1 < this->_size)
+						_apply_columns(next, *this->_BB, cur);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+				}
+				this->casenumber = 1 - this->casenumber;
+
+				if (! _checkpoint.empty() && ((i+1) % _period == 0) && (i+1 < this->_size))
+					_save_checkpoint(i+1);
+			}
+		}
+
+		// Hash of A times the first column of V, before any recording
+		uint64_t _probe()
+		{
+			std::vector<Element> x(this->_nn), y(this->_BB->rowdim());
+			for (size_t k = 0; k < this->_nn; ++k)
+				this->field().assign(x[k], this->_blockV.getEntry(k, 0));
+			blackboxApply(y, *this->_BB, x, _z);
+			std::vector<uint8_t> bytes;
+			serialize(bytes, y);
+			return hash_bytes(bytes);
+		}
+
+		// Reads value at offset, false on short input
+		template<class T>
+		static bool _read(T& value, const std::vector<uint8_t>& bytes, uint64_t& offset)
+		{
+			uint64_t r = unserialize(value, bytes, offset);
+			offset += r;
+			return r != 0;
+		}
+
+		// Checkpoint format: _size, m, n, fingerprint, step, casenumber, current block, _rep[0..step-1]
+		void _save_checkpoint(size_t step)
+		{
+			std::vector<uint8_t> bytes;
+			serialize(bytes, (uint64_t)this->_size);
+			serialize(bytes, (uint64_t)this->_m);
+			serialize(bytes, (uint64_t)this->_n);
+			serialize(bytes, _fingerprint);
+			serialize(bytes, (uint64_t)step);
+			serialize(bytes, (int64_t)this->casenumber);
+			serialize(bytes, this->casenumber ? this->_blockV : _blockW);
+			for (size_t i = 0; i < step; ++i)
+				serialize(bytes, _rep[i]);
+			if (! write_bytes(_checkpoint, bytes))
+				commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+					<< "could not write checkpoint " << _checkpoint << std::endl;
+		}
+
+		// Returns the step to resume from, 0 if there is no usable checkpoint
+		size_t _load_checkpoint()
+		{
+			std::vector<uint8_t> bytes;
+			if (! read_bytes(bytes, _checkpoint) || bytes.empty())
+				return 0;
+
+			uint64_t size, m, n, fingerprint, step; int64_t cn;
+			uint64_t offset = 0;
+			if (! (_read(size, bytes, offset) && _read(m, bytes, offset) && _read(n, bytes, offset)
+			       && _read(fingerprint, bytes, offset) && _read(step, bytes, offset) && _read(cn, bytes, offset)))
+				return _reject("truncated");
+			if (size != this->_size || m != this->_m || n != this->_n || step == 0 || step > size)
+				return _reject("of another shape");
+			if (fingerprint != _fingerprint)
+				return _reject("of another blackbox");
+
+			Block cur(this->field(), this->_nn, this->_n);
+			if (! _read(cur, bytes, offset) || cur.rowdim() != this->_nn || cur.coldim() != this->_n)
+				return _reject("truncated");
+			std::vector<Value> rep(step, Value(this->field()));
+			for (size_t i = 0; i < step; ++i)
+				if (! _read(rep[i], bytes, offset) || rep[i].rowdim() != this->_m || rep[i].coldim() != this->_n)
+					return _reject("truncated");
+
+			// The first element must be U.V for the projections given
+			if (! _BMD.areEqual(rep[0], this->_value))
+				return _reject("of other projections");
+
+			for (size_t i = 0; i < step; ++i)
+				_rep[i] = rep[i];
+			this->casenumber = (long)cn;
+			if (this->casenumber) this->_blockV = cur;
+			else _blockW = cur;
+			return step;
+		}
+
+		// Warns that the checkpoint file is not used, returns 0
+		size_t _reject(const char* why)
+		{
+			commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+				<< "ignoring checkpoint " << _checkpoint << ", " << why << std::endl;
+			return 0;
+		}
+
 		// launcher of computation of sequence element
 		void _launch_record ()
 		{
@@ -444,7 +642,7 @@ namespace LinBox
 		{
 			if ( _iter < this->_size) {
 				if ( _case == 1) {
-					this->_BB->applyTranspose(_w,_u);
+					blackboxApplyTranspose(_w, *this->_BB, _u, _z);
 					std::vector<Element> _row_value(this->_n);
 					_BMD.mul(_row_value, _w, _Vcopy);
 					this->_value  = _rep[_iter];
@@ -454,7 +652,7 @@ namespace LinBox
 					_case =0;
 				}
 				else {
-					this->_BB->applyTranspose(_u,_w);
+					blackboxApplyTranspose(_u, *this->_BB, _w, _z);
 					std::vector<Element> _row_value(this->_n);
 					_BMD.mul(_row_value, _u, _Vcopy);
 					this->_value  = _rep[_iter];
@@ -472,7 +670,7 @@ namespace LinBox
 		{
 			if ( _iter < this->_size) {
 				if ( _case == 1) {
-					this->_BB->apply(_w,_u);
+					blackboxApply(_w, *this->_BB, _u, _z);
 					std::vector<Element> _col_value(this->_m);
 					_BMD.mul(_col_value, this->_blockU, _w);
 					this->_value  = _rep[_iter];
@@ -482,7 +680,7 @@ namespace LinBox
 					_case =0;
 				}
 				else {
-					this->_BB->apply(_u,_w);
+					blackboxApply(_u, *this->_BB, _w, _z);
 					std::vector<Element> _col_value(this->_m);
 					_BMD.mul(_col_value, this->_blockU, _u);
 					this->_value  = _rep[_iter];
@@ -34,6 +34,7 @@
 
 
 #include "linbox/vector/vector-domain.h"
+#include "linbox/blackbox/apply-workspace.h"
 
 namespace LinBox
 {
@@ -64,7 +65,7 @@ namespace LinBox
 		BlackboxContainerBase (const Blackbox *BB, const Field &F) :
 			_field (&F), _VD (F), _BB (BB), _size ((long)MIN (BB->rowdim (), BB->coldim ()))
 			,casenumber(0)
-			,u(F),v(F)
+			,u(F),v(F),_z(F)
 		{
 			_size <<= 1;
 		}
@@ -74,7 +75,7 @@ namespace LinBox
 		BlackboxContainerBase (const Blackbox *BB, const Field &F, size_t Size) :
 			_field (&F), _VD (F), _BB (BB), _size ((long)Size)
 			,casenumber(0)
-			,u(F),v(F)
+			,u(F),v(F),_z(F)
 		{}
 
 		virtual ~BlackboxContainerBase ()
@@ -128,6 +129,7 @@ namespace LinBox
 		// BDS 22.03.03 // bb : what is casenumber ?
 		long                 casenumber;
 		BlasVector<Field>    u, v;
+		BlasVector<Field>    _z;     // workspace of the applies (see has_apply_workspace)
 		Element              _value;
 
 		const Element &getvalue() { return _value; }
@@ -71,7 +71,7 @@ namespace LinBox
 			if (this->casenumber > 0) {
 				if (this->casenumber == 1) {
 					this->casenumber = 2;
-					this->_BB->apply (this->v, this->u);                // this->v <- B(B^i u_0) = B^(i+1) u_0
+					blackboxApply (this->v, *this->_BB, this->u, this->_z);         // this->v <- B(B^i u_0) = B^(i+1) u_0
 					this->_VD.dot (this->_value, this->u, this->v);     // t <- this->u^t this->v = u_0^t B^(2i+1) u_0
 				}
 				else {
@@ -86,7 +86,7 @@ namespace LinBox
 				}
 				else {
 					this->casenumber = 0;
-					this->_BB->apply (this->u, this->v);                // this->u <- B(B^(i+1) u_0) = B^(i+2) u_0
+					blackboxApply (this->u, *this->_BB, this->v, this->_z);         // this->u <- B(B^(i+1) u_0) = B^(i+2) u_0
 					this->_VD.dot (this->_value, this->v, this->u);     // t <- this->v^t this->u = u_0^t B^(2i+3) u_0
 				}
 			}
@@ -88,12 +88,12 @@ namespace LinBox
 		{
 			if (this->casenumber) {
 				this->casenumber = 0;
-				this->_BB->apply (this->v, this->u);
+				blackboxApply (this->v, *this->_BB, this->u, this->_z);
 				this->_VD.dot (this->_value, this->v, this->v);
 			}
 			else {
 				this->casenumber = 1;
-				this->_BB->applyTranspose (this->u, this->v);
+				blackboxApplyTranspose (this->u, *this->_BB, this->v, this->_z);
 				this->_VD.dot (this->_value, this->u, this->u);
 			}
 		}
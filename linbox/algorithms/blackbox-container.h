@@ -118,7 +118,7 @@ namespace LinBox
 #ifdef INCLUDE_TIMING
 				_timer.start ();
 #endif // INCLUDE_TIMING
-				this->_BB->apply (this->v, w);  // GV
+				blackboxApply (this->v, *this->_BB, w, this->_z);  // GV
 
 #ifdef INCLUDE_TIMING
 				_timer.stop ();
@@ -139,7 +139,7 @@ namespace LinBox
 #ifdef INCLUDE_TIMING
 				_timer.start ();
 #endif // INCLUDE_TIMING
-				this->_BB->apply (w, this->v);  // GV
+				blackboxApply (w, *this->_BB, this->v, this->_z);  // GV
 
 #ifdef INCLUDE_TIMING
 				_timer.stop ();
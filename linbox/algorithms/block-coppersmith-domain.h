@@ -33,6 +33,10 @@
 
 #include "linbox/util/timer.h"
 
+#ifdef __LINBOX_USE_OPENMP
+#include <omp.h>
+#endif
+
 #if defined(__LINBOX_USE_OPENMP) and defined(__GIVARO_USE_OPENMP)
 #include <omp.h>
 #include "givaro/givomptimer.h"
@@ -253,6 +257,7 @@ EARLY_TERM_THRESHOLD (ett_default)
 			typename BM_Seq::size_type _t;
 			typename BM_Seq::const_iterator _seqel;
 			std::list<Coefficient> _gen;
+			std::list<Coefficient> _nextGen; // storage of the next generator, swapped with _gen
 			std::vector<size_t> _deg;
 			size_t _delta;
 			size_t _mu;
@@ -360,7 +365,7 @@ EARLY_TERM_THRESHOLD (ett_default)
 			//Copy constructor
 			BM_iterator(const BM_Seq::BM_iterator & it) :
 				_MD(&it.domain()), _seq(it._seq), _size(it._size), _t(it._t),
-				_seqel(it._seqel), _gen(it._gen), _deg(it._deg),
+				_seqel(it._seqel), _gen(it._gen), _nextGen(), _deg(it._deg),
 				_delta(it._delta), _mu(it._mu), _beta(it._beta),
 				_sigma(it._sigma), _gensize(it._gensize),
 				_row(it._row), _col(it._col),
@@ -389,6 +394,7 @@ EARLY_TERM_THRESHOLD (ett_default)
 					(*this)._ett     = it._ett;
 					(*this)._etc     = it._etc;
 					_gen.clear();
+					_nextGen.clear();
 					for(typename std::list<Coefficient>::const_iterator git = it._gen.begin(); git != it._gen.end(); ++git)
 						_seq.push_back(*git);
 				}
@@ -549,8 +555,6 @@ EARLY_TERM_THRESHOLD (ett_default)
 				if(_t == _size){
 					return *this;
 				}
-				//Initialize the discrepancy
-				Coefficient disc(field(),_row, _row+_col);
 				//Create two iterators, one for seq, and one for gen
 				typename BM_Seq::const_iterator cseqit;
 				typename std::list<Coefficient>::iterator genit;
@@ -566,21 +570,36 @@ EARLY_TERM_THRESHOLD (ett_default)
 					seqPtrVec.push_back(&(*cseqit));
 					--cseqit;
 				}
-				int numCoeffs=coeffVec.size();
-				std::vector <Coefficient> discComponents;
-				discComponents.reserve(numCoeffs);
-				for (int i=0;i<numCoeffs;++i) {
-					discComponents.push_back(Coefficient(field(),_row,_row+_col));
+				int numCoeffs=(int)coeffVec.size();
+				//One partial discrepancy per thread, each over a contiguous
+				//range of coefficients, then summed by a binary tree.
+				int numParts=1;
+#ifdef __LINBOX_USE_OPENMP
+				numParts=std::max(1,std::min(numCoeffs,omp_get_max_threads()));
+#endif
+				std::vector <Coefficient> discParts;
+				discParts.reserve(numParts);
+				for (int t=0;t<numParts;++t) {
+					discParts.push_back(Coefficient(field(),_row,_row+_col));
 				}
 #ifdef __LINBOX_USE_OPENMP
-#pragma omp parallel for
+#pragma omp parallel for num_threads(numParts) schedule(static,1)
 #endif
-				for (int i=0;i<numCoeffs;++i) {
-					domain().axpyin(discComponents[i],*(seqPtrVec[i]),*(coeffVec[i]));
+				for (int t=0;t<numParts;++t) {
+					int first = (int)(((long)numCoeffs*t)/numParts);
+					int last  = (int)(((long)numCoeffs*(t+1))/numParts);
+					for (int i=first;i<last;++i)
+						domain().axpyin(discParts[t],*(seqPtrVec[i]),*(coeffVec[i]));
 				}
-				for (int i=0;i<numCoeffs;++i) {
-					domain().addin(disc,discComponents[i]);
+				for (int step=1;step<numParts;step*=2) {
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for
+#endif
+					for (int t=0;t<numParts-step;t+=2*step) {
+						domain().addin(discParts[t],discParts[t+step]);
+					}
 				}
+				Coefficient& disc = discParts[0];
                                 start1.stop();
 				g_time2 += start1.realtime();
 
@@ -596,45 +615,61 @@ EARLY_TERM_THRESHOLD (ett_default)
 				Algorithm3dot2(tau, disc, _deg, _mu, _sigma, _beta);
                                 start2.stop();
 				g_time3 += start2.realtime();
-				CTimer start3; start3.start();
-				//Multiply tau into each matrix in the generator
-#ifdef __LINBOX_USE_OPENMP
-#pragma omp parallel for
-#endif
-				for (int i=0;i<numCoeffs;++i) {
-					domain().mulin(*(coeffVec[i]),tau);
-				}
-                                start3.stop();
-				g_time4 += start3.realtime();
 				//Increment the auxiliary degrees and beta
 				for(size_t j = _col; j <_row+_col; ++j)
 					_deg[j]++;
 				++_beta;
-				//Add a zero matrix to the end of the generator if needed.
+				//The generator grows by one coefficient if needed.
 				int tmax = (int)_deg[0];
 				for(size_t j = 1; j<_row+_col; ++j)
 					if(tmax < (int)_deg[j])
 						tmax = (int)_deg[j];
+				int newSize = numCoeffs;
 				if(tmax+1 > (int)_gensize){
-					_gen.push_back(Coefficient(field(),_col,_row+_col));
-					++_gensize;
+					++newSize;
 				}
-				//Mimic multiplication be z in the auxiliary columns
-				typename std::list<Coefficient>::reverse_iterator g1,g2;
-				g1 = _gen.rbegin();
-				g2 = _gen.rbegin();
-				++g1;
-				while(g1!=_gen.rend()){
-					Sub g1aux(*g1,0,_col,_col,_row);
-					Sub g2aux(*g2,0,_col,_col,_row);
-					domain().copy(g2aux,g1aux);
-					++g1;
-					++g2;
+
+				CTimer start3; start3.start();
+				//Multiply tau into the generator and mimic the multiplication
+				//by z in the auxiliary columns in a single pass: the new
+				//coefficient k is [ G_k.tau_gen | G_{k-1}.tau_aux ].
+				//Every coefficient is independent, so they are all computed
+				//in parallel, into the storage of the generator before the
+				//current one, which is then swapped in without any copy.
+				Sub tauGen(tau,0,0,_row+_col,_col);
+				Sub tauAux(tau,0,_col,_row+_col,_row);
+				while ((int)_nextGen.size() > newSize) {
+					_nextGen.pop_back();
 				}
-				genit = _gen.begin();
-				Coefficient z1(field(),_col,_row);
-				Sub genitaux(*genit,0,_col,_col,_row);
-				domain().copy(genitaux,z1);
+				while ((int)_nextGen.size() < newSize) {
+					_nextGen.push_back(Coefficient(field(),_col,_row+_col));
+				}
+				std::vector<Coefficient*> newVec;
+				newVec.reserve(newSize);
+				for(genit = _nextGen.begin(); genit!=_nextGen.end(); ++genit){
+					newVec.push_back(&(*genit));
+				}
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+				for (int k=0;k<newSize;++k) {
+					Sub newGenPart(*(newVec[k]),0,0,_col,_col);
+					Sub newAuxPart(*(newVec[k]),0,_col,_col,_row);
+					if (k < numCoeffs)
+						domain().mul(newGenPart,*(coeffVec[k]),tauGen);
+					else
+						newGenPart.zero();
+					if (k > 0)
+						domain().mul(newAuxPart,*(coeffVec[k-1]),tauAux);
+					else
+						newAuxPart.zero();
+				}
+				_gen.swap(_nextGen);
+				if (newSize > numCoeffs) {
+					++_gensize;
+				}
+                                start3.stop();
+				g_time4 += start3.realtime();
 				//Increment the t and seqel to the next element
 				++_t;
 				++_seqel;
@@ -0,0 +1,315 @@
+/* linbox/algorithms/cra-checkpoint.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/cra-checkpoint.h
+ * @ingroup CRA
+ * @brief Journal of a CRA loop, for checkpoint/restart.
+ *
+ * Each prime handled by the loop is appended to a file, with its residue
+ * when the builder was given one: replaying the journal in order rebuilds
+ * exactly the state of the builder and the prime counters, whatever the
+ * builder (early or full termination, scalar or vector). The records are
+ * written through util/serialization.h every \c period primes, so that
+ * at most \c period residues are lost when the job is killed. A record
+ * cut by the kill is dropped when the journal is read back.
+ *
+ * The journal starts with a fingerprint of its computation, made from
+ * an identifier of the input given by the caller, the builder type and
+ * its bound. A journal of another fingerprint is not replayed but
+ * replaced. The journal is removed once the CRA has terminated.
+ */
+
+#ifndef __LINBOX_cra_checkpoint_H
+#define __LINBOX_cra_checkpoint_H
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "linbox/integer.h"
+#include "linbox/util/commentator.h"
+#include "linbox/util/serialization.h"
+
+namespace LinBox
+{
+
+	/// Whether \c serialize(bytes, T) exists.
+	template <class T, class = void>
+	struct IsSerializable : std::false_type {};
+
+	template <class T>
+	struct IsSerializable<T, decltype((void)serialize(std::declval<std::vector<uint8_t>&>(), std::declval<const T&>()))> :
+		std::true_type {};
+
+	/** \brief Journal of the primes and residues of a CRA loop.
+	 * \ingroup CRA
+	 *
+	 * Record format: length of the rest of the record (8 bytes),
+	 * Record kind (8 bytes), prime (Integer), then the residue for
+	 * Initialize and Progress records. The first record is a Header,
+	 * whose prime is the fingerprint.
+	 */
+	class CRACheckpoint {
+	public:
+		//! What the loop did with a prime.
+		enum class Record : int64_t {
+			Initialize = 0, //!< the builder was (re)initialized with its residue
+			Progress = 1,   //!< its residue was added to the builder
+			Skip = 2,       //!< bad prime, skipped
+			Discard = 3,    //!< good prime, discarded by a restart
+			Header = 4      //!< fingerprint of the computation
+		};
+
+		struct Entry {
+			Record kind;
+			Integer prime;
+			uint64_t offset; //!< position of the residue in the journal
+		};
+
+		/** \p filename empty for no journal, records written every \p period primes,
+		 * \p fingerprint of the computation (see fingerprint()).
+		 */
+		CRACheckpoint (const std::string& filename = "", size_t period = 1, uint64_t fingerprint = 0) :
+			_filename(filename), _period(std::max(period, (size_t)1)), _pending(0),
+			_fingerprint(fingerprint), _started(false)
+		{}
+
+		/// Fingerprint of a computation: the caller's identifier of the input, the builder type and its parameters.
+		static uint64_t fingerprint (const std::string& input, const std::string& builder, const std::vector<uint8_t>& params)
+		{
+			std::vector<uint8_t> bytes;
+			serialize(bytes, std::vector<uint8_t>(input.begin(), input.end()));
+			serialize(bytes, std::vector<uint8_t>(builder.begin(), builder.end()));
+			serialize(bytes, params);
+			return hash_bytes(bytes);
+		}
+
+		bool active () const { return ! _filename.empty(); }
+		const std::string& filename () const { return _filename; }
+		size_t period () const { return _period; }
+
+		/// Whether \p p is in the journal, or was marked as used.
+		bool used (const Integer& p) const { return _used.count(p) != 0; }
+		void markUsed (const Integer& p) { _used.insert(p); }
+		const std::set<Integer>& usedPrimes () const { return _used; }
+
+		/// Appends a record with its residue.
+		template <class Residue>
+		void record (Record kind, const Integer& p, const Residue& r)
+		{
+			if (! active()) return;
+			_record(kind, p, r, IsSerializable<Residue>());
+		}
+
+		/// Appends a record without residue (Skip, Discard).
+		void record (Record kind, const Integer& p)
+		{
+			if (! active()) return;
+			std::vector<uint8_t> payload;
+			serialize(payload, (int64_t)kind);
+			serialize(payload, p);
+			_append(p, payload);
+		}
+
+		/// Writes the pending records to the file, after the header for a new journal.
+		void flush ()
+		{
+			if (! active() || _buffer.empty()) return;
+			if (! _started) {
+				std::vector<uint8_t> header;
+				serialize(header, (int64_t)Record::Header);
+				serialize(header, Integer(_fingerprint));
+				std::vector<uint8_t> bytes;
+				serialize(bytes, (uint64_t)header.size());
+				bytes.insert(bytes.end(), header.begin(), header.end());
+				if (! write_bytes(_filename, bytes)) {
+					commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+						<< "could not write checkpoint " << _filename << std::endl;
+					return;
+				}
+				_started = true;
+			}
+			std::ofstream out(_filename, std::ios::binary | std::ios::app);
+			out.write(reinterpret_cast<const char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+			if (! out)
+				commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+					<< "could not write checkpoint " << _filename << std::endl;
+			_buffer.clear();
+			_pending = 0;
+		}
+
+		/** Reads the journal back, in order.
+		 * A truncated last record is dropped and the file is rewritten without it.
+		 * Records of primes already read are ignored. A journal of another
+		 * fingerprint is not read, and is replaced at the next flush().
+		 */
+		const std::vector<Entry>& load ()
+		{
+			_entries.clear();
+			_journal.clear();
+			if (! active() || ! read_bytes(_journal, _filename) || _journal.empty())
+				return _entries;
+
+			uint64_t offset = 0;
+			bool header = true;
+			while (offset + 8 <= _journal.size()) {
+				uint64_t length;
+				unserialize(length, _journal, offset);
+				if (length > _journal.size() - offset - 8)
+					break;
+
+				Entry e;
+				int64_t kind = -1;
+				uint64_t pos = offset + 8, r;
+				if ((r = unserialize(kind, _journal, pos)) == 0) break;
+				pos += r;
+				if ((r = unserialize(e.prime, _journal, pos)) == 0) break;
+				pos += r;
+				e.kind = (Record)kind;
+				e.offset = pos;
+				offset += 8 + length;
+
+				if (header) {
+					header = false;
+					if (e.kind != Record::Header || e.prime != Integer(_fingerprint)) {
+						commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+							<< "checkpoint " << _filename << " is the journal of another computation, starting a new one" << std::endl;
+						_journal.clear();
+						return _entries;
+					}
+					_started = true;
+					continue;
+				}
+				if (used(e.prime)) continue;
+				markUsed(e.prime);
+				_entries.push_back(e);
+			}
+
+			if (! _started) {
+				_journal.clear();
+				return _entries;
+			}
+			if (offset < _journal.size()) {
+				commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+					<< "dropping a truncated record of checkpoint " << _filename << std::endl;
+				_journal.resize(offset);
+				write_bytes(_filename, _journal);
+			}
+
+			commentator().report(Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+				<< "resuming from checkpoint " << _filename << ", " << _entries.size() << " primes" << std::endl;
+			return _entries;
+		}
+
+		/// Residue of \p e, a loaded Initialize or Progress record.
+		template <class Residue>
+		Residue& residue (Residue& r, const Entry& e) const
+		{
+			return _residue(r, e, IsSerializable<Residue>());
+		}
+
+		/// Frees the journal once it has been replayed.
+		void release ()
+		{
+			std::vector<Entry>().swap(_entries);
+			std::vector<uint8_t>().swap(_journal);
+		}
+
+		/// Removes the journal file, once the computation is over.
+		void remove ()
+		{
+			if (! active()) return;
+			std::remove(_filename.c_str());
+			_buffer.clear();
+			_pending = 0;
+			_started = false;
+		}
+
+	protected:
+		std::string _filename;
+		size_t _period;
+		size_t _pending;                //!< records in the buffer
+		std::vector<uint8_t> _buffer;   //!< records not written yet
+		std::set<Integer> _used;
+		std::vector<Entry> _entries;
+		std::vector<uint8_t> _journal;
+		uint64_t _fingerprint;
+		bool _started;                  //!< whether the file starts with our header
+
+		void _append (const Integer& p, const std::vector<uint8_t>& payload)
+		{
+			markUsed(p);
+			serialize(_buffer, (uint64_t)payload.size());
+			_buffer.insert(_buffer.end(), payload.begin(), payload.end());
+			if (++_pending >= _period)
+				flush();
+		}
+
+		template <class Residue>
+		void _record (Record kind, const Integer& p, const Residue& r, std::true_type)
+		{
+			std::vector<uint8_t> payload;
+			serialize(payload, (int64_t)kind);
+			serialize(payload, p);
+			serialize(payload, r);
+			_append(p, payload);
+		}
+
+		// no serialization for these residues: no journal
+		template <class Residue>
+		void _record (Record, const Integer&, const Residue&, std::false_type)
+		{
+			commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+				<< "residues cannot be serialized, no checkpoint written to " << _filename << std::endl;
+			_filename.clear();
+		}
+
+		template <class Residue>
+		Residue& _residue (Residue& r, const Entry& e, std::true_type) const
+		{
+			unserialize(r, _journal, e.offset);
+			return r;
+		}
+
+		template <class Residue>
+		Residue& _residue (Residue& r, const Entry&, std::false_type) const
+		{
+			return r;
+		}
+	};
+
+}
+
+#endif // __LINBOX_cra_checkpoint_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -26,10 +26,17 @@
 
 #pragma once
 
+#include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <givaro/zring.h>
+
+#include "linbox/algorithms/cra-builder-full-multip.h"
+#include "linbox/algorithms/cra-checkpoint.h"
 #include "linbox/algorithms/cra-domain.h"
 #include "linbox/algorithms/rational-cra.h"
 #include "linbox/algorithms/rational-cra-var-prec.h"
@@ -51,23 +58,66 @@ namespace LinBox {
         // using MaskedPrimeGenerator = MaskedPrimeIterator<IteratorCategories::HeuristicTag>;
         using MaskedPrimeGenerator = MaskedPrimeIterator<IteratorCategories::DeterministicTag>;
 
+        //! Partial CRT of the primes of one rank, or of a subtree of ranks.
+        using PartialBuilder = CRABuilderFullMultip<Domain>;
+        //! Builders whose partial results can be merged across ranks.
+        using TreeReducible = std::is_base_of<PartialBuilder, CRABase>;
+
     protected:
         CRABase Builder_;
         Communicator* _pCommunicator;
         double _hadamardLogBound;
         double _workerHadamardLogBound = 0.0; //!< Each worker will compute primes until this is hit.
+        bool _earlyTermination;               //!< Workers compute primes until the master stops them.
+        std::string _checkpointFile;
+        size_t _checkpointPeriod = 1;
+        std::string _checkpointInput;
+        uint64_t _checkpointFingerprint = 0;
+        CRACheckpoint _checkpoint; //!< Journal of this rank, or primes to skip on the workers.
+
+        static constexpr int StopTag = 1; //!< Tag of the stop signal, results use tag 0.
 
     public:
-        ChineseRemainderDistributed(double b, Communicator* c)
+        /** \param b bound given to the builder (log2 of the Hadamard bound, or early termination threshold).
+         * \param c communicator, the master (rank 0) reconstructs and the others compute the residues.
+         * \param earlyTermination if \c true, the workers do not stop at their share of the bound,
+         * but when the master signals that the builder has terminated.
+         * The stop is polled between two primes, without blocking.
+         *
+         * Otherwise, for vector results with a multi-residue builder,
+         * each worker combines its own primes into a partial CRT,
+         * and the partial results are merged along a binary tree of ranks,
+         * rooted at the master.
+         */
+        ChineseRemainderDistributed(double b, Communicator* c, bool earlyTermination = false)
             : Builder_(b)
             , _pCommunicator(c)
             , _hadamardLogBound(b)
+            , _earlyTermination(earlyTermination)
         {
             if (c && c->size() > 1) {
                 _workerHadamardLogBound = _hadamardLogBound / (c->size() - 1);
             }
         }
 
+        /** \brief Checkpoint/restart, see ChineseRemainderSequential::setCheckpoint.
+         *
+         * To be called on every rank. The master journals the residues it
+         * receives to \p filename, and tells the workers which primes to skip
+         * when it resumes. In the tree reduction, each worker journals its own
+         * primes to \p filename.rank instead. The journals are removed
+         * once the result is known.
+         */
+        void setCheckpoint(const std::string& filename, const std::string& input, size_t period = 1)
+        {
+            _checkpointFile = filename;
+            _checkpointPeriod = period;
+            _checkpointInput = input;
+            std::vector<uint8_t> params;
+            serialize(params, _hadamardLogBound);
+            _checkpointFingerprint = CRACheckpoint::fingerprint(input, typeid(CRABase).name(), params);
+        }
+
         /** \brief The CRA loop.
          *
          * \param Iteration  Function object of two arguments, \c
@@ -94,7 +144,9 @@ namespace LinBox {
             para_compute(num, Iteration, primeGenerator);
 
             if (_pCommunicator->master()) {
-                return Builder_.result(num, den);
+                Builder_.result(num, den);
+                if (Builder_.terminated()) _checkpoint.remove();
+                return num;
             }
             else {
                 return num;
@@ -107,13 +159,18 @@ namespace LinBox {
             // Defer to standard CRA loop if no parallel usage is desired
             if (_pCommunicator == 0 || _pCommunicator->size() == 1) {
                 ChineseRemainder<CRABase> sequential(Builder_);
+                if (!_checkpointFile.empty()) {
+                    sequential.setCheckpoint(_checkpointFile, _checkpointInput, _checkpointPeriod);
+                }
                 return sequential(res, Iteration, primeGenerator);
             }
 
             para_compute(res, Iteration, primeGenerator);
 
             if (_pCommunicator->master()) {
-                return Builder_.result(res);
+                Builder_.result(res);
+                if (Builder_.terminated()) _checkpoint.remove();
+                return res;
             }
             else {
                 return res;
@@ -139,6 +196,11 @@ namespace LinBox {
             Domain D(*primeGenerator);
             BlasVector<Domain> r(D);
 
+            if (!_earlyTermination && TreeReducible::value) {
+                tree_process_task(Iteration, r, TreeReducible());
+                return;
+            }
+
             if (_pCommunicator->master()) {
                 master_process_task(Iteration, D, r);
             }
@@ -147,17 +209,59 @@ namespace LinBox {
             }
         }
 
+        //! Returns the log2 of the primes skipped because they were used before a restart.
         template <class Any, class PrimeIterator, class Function>
-        void worker_compute(PrimeIterator& gen, Function& Iteration, Any& r)
+        double worker_compute(PrimeIterator& gen, Function& Iteration, Any& r)
         {
             // Process mutual independent prime number generation
+            double usedLogSum = 0.0;
             ++gen;
-            while (Builder_.noncoprime(*gen)) {
+            while (Builder_.noncoprime(*gen) || _checkpoint.used(*gen)) {
+                if (_checkpoint.used(*gen)) {
+                    usedLogSum += Givaro::logtwo(*gen);
+                }
                 ++gen;
             }
 
             Domain D(*gen);
             Iteration(r, D);
+            return usedLogSum;
+        }
+
+        //! Master: replays its journal into the builder, workers: learn the primes to skip.
+        template <class Any>
+        bool resume(Any& r)
+        {
+            if (_checkpointFile.empty()) {
+                return false;
+            }
+
+            bool initialized = false;
+            std::vector<Integer> used;
+            if (_pCommunicator->master()) {
+                _checkpoint = CRACheckpoint(_checkpointFile, _checkpointPeriod, _checkpointFingerprint);
+                for (const auto& e : _checkpoint.load()) {
+                    Domain D(e.prime);
+                    if (e.kind == CRACheckpoint::Record::Initialize) {
+                        Builder_.initialize(D, _checkpoint.residue(r, e));
+                        initialized = true;
+                    }
+                    else if (e.kind == CRACheckpoint::Record::Progress && initialized) {
+                        Builder_.progress(D, _checkpoint.residue(r, e));
+                    }
+                }
+                _checkpoint.release();
+                used.assign(_checkpoint.usedPrimes().begin(), _checkpoint.usedPrimes().end());
+            }
+            else {
+                _checkpoint = CRACheckpoint();
+            }
+
+            _pCommunicator->bcast(used, 0);
+            for (const auto& p : used) {
+                _checkpoint.markUsed(p);
+            }
+            return initialized;
         }
 
         template <class Any, class Function>
@@ -165,10 +269,17 @@ namespace LinBox {
         {
             MaskedPrimeGenerator gen(_pCommunicator->rank() - 1, _pCommunicator->size() - 1);
 
-            // Each worker will work until _workerHadamardLogBound is hit
+            resume(r);
+
+            // Each worker will work until _workerHadamardLogBound is hit,
+            // or until the master stops it in early termination mode
             double primesLogSum = 0.0;
-            while (primesLogSum < _workerHadamardLogBound) {
-                worker_compute(gen, Iteration, r);
+            while (_earlyTermination || primesLogSum < _workerHadamardLogBound) {
+                if (_earlyTermination && _pCommunicator->probe(0, StopTag)) {
+                    break;
+                }
+
+                primesLogSum += worker_compute(gen, Iteration, r);
 
                 uint64_t p = *gen;
                 primesLogSum += Givaro::logtwo(p);
@@ -183,9 +294,19 @@ namespace LinBox {
         template <class Any, class Function>
         void master_process_task(Function& Iteration, Domain& D, Any& r)
         {
-            Iteration(r, D);
-            Builder_.initialize(D, r);
+            if (!resume(r)) {
+                Iteration(r, D);
+                Builder_.initialize(D, r);
+                Integer p;
+                _checkpoint.record(CRACheckpoint::Record::Initialize, D.characteristic(p), r);
+            }
 
+            bool stopped = _earlyTermination && Builder_.terminated();
+            if (stopped) {
+                for (int worker = 1; worker < _pCommunicator->size(); ++worker) {
+                    _pCommunicator->signal(worker, StopTag);
+                }
+            }
             uint32_t workersDone = _pCommunicator->size() - 1;
             while (workersDone > 0) {
                 // Receive the prime
@@ -199,9 +320,92 @@ namespace LinBox {
                 // Receive result vector and update builder
                 _pCommunicator->recv(r, _pCommunicator->status().MPI_SOURCE);
 
+                // Residues still in flight after the stop are dropped
+                if (stopped) {
+                    continue;
+                }
+
                 Domain D(p);
                 Builder_.progress(D, r);
+                _checkpoint.record(CRACheckpoint::Record::Progress, Integer(p), r);
+
+                if (_earlyTermination && Builder_.terminated()) {
+                    for (int worker = 1; worker < _pCommunicator->size(); ++worker) {
+                        _pCommunicator->signal(worker, StopTag);
+                    }
+                    stopped = true;
+                }
             }
+            _checkpoint.flush();
+        }
+
+        /** Workers reduce their own primes locally, then the partial
+         * results (modulus, residues) are merged pairwise: at step \c s,
+         * rank \c i+s sends to rank \c i, for \c i multiple of \c 2s.
+         * The master only merges, and ends with the whole result in \c Builder_.
+         */
+        template <class Any, class Function>
+        void tree_process_task(Function& Iteration, Any& r, std::true_type)
+        {
+            PartialBuilder workerBuilder(_hadamardLogBound);
+            PartialBuilder& partial = _pCommunicator->master() ? static_cast<PartialBuilder&>(Builder_) : workerBuilder;
+
+            const int rank = _pCommunicator->rank();
+            const int size = _pCommunicator->size();
+
+            if (!_pCommunicator->master()) {
+                MaskedPrimeGenerator gen(rank - 1, size - 1);
+
+                // Each worker replays its own journal
+                double primesLogSum = 0.0;
+                _checkpoint = CRACheckpoint(_checkpointFile.empty() ? _checkpointFile : _checkpointFile + "." + std::to_string(rank),
+                                            _checkpointPeriod, _checkpointFingerprint);
+                for (const auto& e : _checkpoint.load()) {
+                    Domain D(e.prime);
+                    partial.progress(D, _checkpoint.residue(r, e));
+                    primesLogSum += Givaro::logtwo(e.prime);
+                }
+                _checkpoint.release();
+
+                while (primesLogSum < _workerHadamardLogBound) {
+                    worker_compute(gen, Iteration, r);
+
+                    uint64_t p = *gen;
+                    primesLogSum += Givaro::logtwo(p);
+                    Domain D(p);
+                    partial.progress(D, r);
+                    _checkpoint.record(CRACheckpoint::Record::Progress, Integer(p), r);
+                }
+                _checkpoint.flush();
+            }
+
+            Givaro::ZRing<Integer> Z;
+            BlasVector<Givaro::ZRing<Integer>> residue(Z);
+            Integer modulus;
+            for (int step = 1; step < size; step <<= 1) {
+                if (rank % (2 * step) == step) {
+                    partial.getModulus(modulus);
+                    partial.getResidue(residue);
+                    _pCommunicator->send(modulus, rank - step);
+                    _pCommunicator->send(residue, rank - step);
+                    // the partial result has left this rank
+                    _checkpoint.remove();
+                    break;
+                }
+
+                if (rank + step < size) {
+                    _pCommunicator->recv(modulus, rank + step);
+                    _pCommunicator->recv(residue, rank + step);
+                    if (modulus > 1) {
+                        partial.progress(modulus, residue);
+                    }
+                }
+            }
+        }
+
+        template <class Any, class Function>
+        void tree_process_task(Function& Iteration, Any& r, std::false_type)
+        {
         }
     };
 }
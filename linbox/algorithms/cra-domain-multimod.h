@@ -0,0 +1,154 @@
+/* linbox/algorithms/cra-domain-multimod.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/cra-domain-multimod.h
+ * @brief Multi-modular version of \ref CRA, several primes per iteration
+ * @ingroup CRA
+ */
+
+#ifndef __LINBOX_multimod_cra_H
+#define __LINBOX_multimod_cra_H
+
+#include <set>
+#include <utility>
+#include <vector>
+#include "linbox/algorithms/cra-domain.h"
+
+namespace LinBox
+{
+
+	/** \brief CRA loop handing \c k primes at once to each iteration.
+	 * @ingroup CRA
+	 *
+	 * The iteration is a function object of three arguments, \c
+	 * Iteration(results, r, D), which, given the vector \p D of \c k prime
+	 * fields, sets each \c r[i] to the residue(s) modulo \c D[i] and each
+	 * \c results[i] to the IterationResult of that prime. This lets the
+	 * iteration share one traversal of the input between the primes,
+	 * as in multiModMinpoly() and multiModDet().
+	 *
+	 * If LINBOX_USES_OPENMP is defined, each round runs one batch of \c k
+	 * primes per thread, as ChineseRemainderOMP runs one prime per thread.
+	 * The iteration must then be reentrant.
+	 *
+	 * With \c k = 1, this is ChineseRemainderSequential.
+	 */
+	template<class CRABase>
+	struct ChineseRemainderMultiMod : public ChineseRemainderSequential<CRABase> {
+		typedef typename CRABase::Domain	Domain;
+		typedef typename CRABase::DomainElement	DomainElement;
+		typedef ChineseRemainderSequential<CRABase>    Father_t;
+
+	protected:
+		size_t k_;
+
+	public:
+		template<class Param>
+		ChineseRemainderMultiMod(const Param& b, size_t k) :
+			Father_t(b), k_(k)
+		{}
+
+		ChineseRemainderMultiMod(const CRABase& b, size_t k) :
+			Father_t(b), k_(k)
+		{}
+
+		//! Number of primes of each iteration.
+		size_t primesPerIteration() const { return k_; }
+
+		template <class ResultType, class Function, class PrimeIterator>
+		ResultType& operator() (ResultType& res, Function& Iteration, PrimeIterator& primeiter)
+		{
+			using ResidueType = typename CRAResidue<ResultType,Function>::template ResidueType<Domain>;
+			if (k_ <= 1) return Father_t::operator()(res,Iteration,primeiter);
+#ifdef LINBOX_USES_OPENMP
+			const size_t NN = (size_t)omp_get_max_threads();
+#else
+			const size_t NN = 1;
+#endif
+
+			commentator().start ("Multi-modular iteration", "mmcramm");
+			this->template resume<ResultType,Function>();
+
+			// one batch of k_ primes per thread
+			std::vector<std::vector<Domain> > BATCHdomains(NN);
+			std::vector<std::vector<ResidueType> > BATCHresidues(NN);
+			std::vector<std::vector<IterationResult> > BATCHresults(NN);
+			std::vector<Domain> ROUNDdomains; ROUNDdomains.reserve(NN*k_);
+			std::vector<ResidueType> ROUNDresidues; ROUNDresidues.reserve(NN*k_);
+			std::vector<IterationResult> ROUNDresults; ROUNDresults.reserve(NN*k_);
+			std::set<Integer> coprimeset;
+
+			while (! this->Builder_.terminated()) {
+				coprimeset.clear();
+
+				while (coprimeset.size() < NN*k_) {
+					coprimeset.emplace(this->get_coprime(primeiter));
+					++primeiter;
+				}
+
+				auto coprimesetiter = coprimeset.cbegin();
+				for (size_t b = 0; b < NN; ++b) {
+					BATCHdomains[b].clear();
+					BATCHresidues[b].clear();
+					for (size_t i = 0; i < k_; ++i, ++coprimesetiter) {
+						BATCHdomains[b].emplace_back(*coprimesetiter);
+						BATCHresidues[b].emplace_back(CRAResidue<ResultType,Function>::create(BATCHdomains[b].back()));
+					}
+					BATCHresults[b].assign(k_, IterationResult::CONTINUE);
+				}
+
+#ifdef LINBOX_USES_OPENMP
+#pragma omp parallel for if (NN > 1)
+#endif
+				for (size_t b = 0; b < NN; ++b)
+					Iteration(BATCHresults[b], BATCHresidues[b], BATCHdomains[b]);
+
+				ROUNDdomains.clear();
+				ROUNDresidues.clear();
+				ROUNDresults.clear();
+				for (size_t b = 0; b < NN; ++b) {
+					ROUNDdomains.insert(ROUNDdomains.end(), BATCHdomains[b].begin(), BATCHdomains[b].end());
+					for (auto& r : BATCHresidues[b])
+						ROUNDresidues.emplace_back(std::move(r));
+					ROUNDresults.insert(ROUNDresults.end(), BATCHresults[b].begin(), BATCHresults[b].end());
+				}
+
+				this->incorporate(ROUNDdomains, ROUNDresidues, ROUNDresults);
+			}
+
+			commentator().stop ("done", NULL, "mmcramm");
+			this->Builder_.result(res);
+			this->closeCheckpoint();
+			return res;
+		}
+	};
+}
+
+#endif //__LINBOX_multimod_cra_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
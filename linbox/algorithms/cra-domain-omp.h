@@ -67,6 +67,8 @@ namespace LinBox
 			// commentator().start ("Parallel OMP Givaro::Modular iteration", "mmcrait");
 			if (NN == 1) return Father_t::operator()(res,Iteration,primeiter);
 
+			this->template resume<ResultType,Function>();
+
 			std::vector<Domain> ROUNDdomains; ROUNDdomains.reserve(NN);
 			std::vector<ResidueType> ROUNDresidues; ROUNDresidues.reserve(NN);
 			std::vector<IterationResult> ROUNDresults(NN);
@@ -94,39 +96,15 @@ namespace LinBox
 				}
 #pragma omp barrier
 
-				// if any thread says RESTART, then all CONTINUEs become SKIPs
-				bool anyrestart = false;
-				for (auto res : ROUNDresults) {
-					if (res == IterationResult::RESTART) anyrestart = true;
-				}
-				if (anyrestart) {
-					this->nbad_ += this->ngood_;
-					this->ngood_ = 0;
-				}
-
-				for (size_t i = 0; i < NN; ++i) {
-					if (ROUNDresults[i] == IterationResult::SKIP) {
-						this->doskip();
-					}
-					else if (anyrestart && ROUNDresults[i] == IterationResult::CONTINUE) {
-						// commentator should indicate that this prime is bad
-						++this->nbad_;
-					}
-					else if (this->ngood_ == 0) {
-						this->ngood_ = 1;
-						this->Builder_.initialize(ROUNDdomains[i], ROUNDresidues[i]);
-					}
-					else {
-						++this->ngood_;
-						this->Builder_.progress(ROUNDdomains[i], ROUNDresidues[i]);
-					}
-				}
+				this->incorporate(ROUNDdomains, ROUNDresidues, ROUNDresults);
 				//std::cerr << "Computed: " << iterCount() << " primes." << std::endl;
 			}
 
 			// commentator().stop ("done", NULL, "mmcrait");
 			//std::cerr << "Used: " << this->iterCount() << " primes." << std::endl;
-			return this->Builder_.result(res);
+			this->Builder_.result(res);
+			this->closeCheckpoint();
+			return res;
 		}
 	};
 }
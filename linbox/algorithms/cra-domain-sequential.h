@@ -34,7 +34,11 @@
 #include "linbox/integer.h"
 #include "linbox/solutions/methods.h"
 #include "linbox/vector/blas-vector.h"
+#include "linbox/algorithms/cra-checkpoint.h"
+#include <type_traits>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 #include <stdlib.h>
 #include "linbox/util/commentator.h"
 
@@ -57,6 +61,17 @@ namespace LinBox
 		int ngood_ = 0;
 		int nbad_ = 0;
 		int nskip_ = 0;
+		CRACheckpoint checkpoint_;
+		bool resumed_ = false;
+		std::vector<uint8_t> params_;   //!< numeric parameters of the builder, for the checkpoint fingerprint
+
+		template <class T>
+		typename std::enable_if<std::is_arithmetic<typename std::decay<T>::type>::value>::type
+		addParam(const T& x) { serialize(params_, (double)x); }
+
+		template <class T>
+		typename std::enable_if<! std::is_arithmetic<typename std::decay<T>::type>::value>::type
+		addParam(const T&) {}
 
 		/** \brief Helper class to sample unique primes.
 		*/
@@ -101,7 +116,107 @@ namespace LinBox
 		 */
 		template <class PrimeIterator>
 		inline auto get_coprime(PrimeIterator& primeiter) const -> decltype(*primeiter) {
-			return PrimeSampler<PrimeIterator>(*this, primeiter)();
+			PrimeSampler<PrimeIterator> sampler(*this, primeiter);
+			// primes of the checkpoint were used before the restart
+			while (checkpoint_.used(sampler()))
+				++primeiter;
+			return *primeiter;
+		}
+
+		/** \brief Appends what was done with the prime of \p D to the checkpoint.
+		 */
+		template <class Residue>
+		void checkpoint(CRACheckpoint::Record kind, const Domain& D, const Residue& r) {
+			if (! checkpoint_.active()) return;
+			Integer p; D.characteristic(p);
+			checkpoint_.record(kind, p, r);
+		}
+
+		void checkpoint(CRACheckpoint::Record kind, const Domain& D) {
+			if (! checkpoint_.active()) return;
+			Integer p; D.characteristic(p);
+			checkpoint_.record(kind, p);
+		}
+
+		/** \brief Replays the checkpoint, once, before the first iteration.
+		 */
+		template <class ResultType, class Function>
+		void resume() {
+			if (resumed_ || ! checkpoint_.active()) return;
+			resumed_ = true;
+			for (const auto& e : checkpoint_.load()) {
+				Domain D(e.prime);
+				auto r = CRAResidue<ResultType,Function>::create(D);
+				switch (e.kind) {
+				case CRACheckpoint::Record::Initialize:
+					checkpoint_.residue(r, e);
+					nbad_ += ngood_;
+					ngood_ = 1;
+					Builder_.initialize(D, r);
+					break;
+				case CRACheckpoint::Record::Progress:
+					checkpoint_.residue(r, e);
+					++ngood_;
+					Builder_.progress(D, r);
+					break;
+				case CRACheckpoint::Record::Skip:
+					++nbad_;
+					++nskip_;
+					break;
+				case CRACheckpoint::Record::Discard:
+					++nbad_;
+					break;
+				}
+			}
+			checkpoint_.release();
+		}
+
+		/** \brief Writes the checkpoint, or removes it when the loop has terminated.
+		 */
+		void closeCheckpoint() {
+			checkpoint_.flush();
+			if (Builder_.terminated())
+				checkpoint_.remove();
+		}
+
+		/** \brief Incorporates the residues of a round of iterations on several primes.
+		 *
+		 * If any iteration of the round says RESTART, the previous primes
+		 * and the CONTINUEs of the round are discarded.
+		 */
+		template <class Residue>
+		void incorporate(const std::vector<Domain>& domains, std::vector<Residue>& residues,
+						 const std::vector<IterationResult>& results) {
+			bool anyrestart = false;
+			for (auto r : results) {
+				if (r == IterationResult::RESTART) anyrestart = true;
+			}
+			if (anyrestart) {
+				nbad_ += ngood_;
+				ngood_ = 0;
+			}
+
+			for (size_t i = 0; i < results.size(); ++i) {
+				if (results[i] == IterationResult::SKIP) {
+					doskip();
+					checkpoint(CRACheckpoint::Record::Skip, domains[i]);
+				}
+				else if (anyrestart && results[i] == IterationResult::CONTINUE) {
+					// commentator should indicate that this prime is bad
+					++nbad_;
+					checkpoint(CRACheckpoint::Record::Discard, domains[i]);
+				}
+				else if (ngood_ == 0) {
+					ngood_ = 1;
+					Builder_.initialize(domains[i], residues[i]);
+					checkpoint(CRACheckpoint::Record::Initialize, domains[i], residues[i]);
+				}
+				else {
+					++ngood_;
+					Builder_.progress(domains[i], residues[i]);
+					checkpoint(CRACheckpoint::Record::Progress, domains[i], residues[i]);
+				}
+			}
 		}
 
 	public:
@@ -110,7 +225,10 @@ namespace LinBox
 		template <typename... Args>
 		ChineseRemainderSequential(Args&&... args) :
 			Builder_(std::forward<Args>(args)...)
-		{ }
+		{
+			int expand[] = { 0, (addParam(args), 0)... };
+			(void)expand;
+		}
 
 		/** \brief How many iterations have been performed so far.
 		 *
@@ -120,6 +238,22 @@ namespace LinBox
 			return ngood_ + nbad_;
 		}
 
+		/** \brief Checkpoint/restart of the loop.
+		 *
+		 * Every prime, with its residue, is journaled to \p filename;
+		 * the journal is written every \p period primes. If \p filename
+		 * already holds the journal of an interrupted run of the same
+		 * computation, the next loop first replays it and does not use
+		 * its primes again. The computation is identified by \p input,
+		 * which the caller derives from the input (a hash of the matrix,
+		 * a file name...), the builder type and its bound. The journal
+		 * is removed once the loop has terminated.
+		 */
+		void setCheckpoint(const std::string& filename, const std::string& input, size_t period = 1) {
+			checkpoint_ = CRACheckpoint(filename, period, CRACheckpoint::fingerprint(input, typeid(CRABase).name(), params_));
+			resumed_ = false;
+		}
+
             /** \brief The \ref CRA loop
              *
              * Given a function to generate residues \c mod a single prime,
@@ -173,9 +307,11 @@ namespace LinBox
 		template<class ResultType, class Function, class PrimeIterator>
 		bool operator() (int k, ResultType& res, Function& Iteration, PrimeIterator& primeiter)
             {
+				resume<ResultType,Function>();
+
 				while (k != 0 && ngood_ == 0) {
 					--k;
-					Domain D(*primeiter);
+					Domain D(get_coprime(primeiter));
                     commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION) << "With prime " << *primeiter << std::endl;
 					++primeiter;
 					auto r = CRAResidue<ResultType,Function>::create(D);
@@ -184,10 +320,12 @@ namespace LinBox
 #endif
 					if (Iteration(r,D) == IterationResult::SKIP) {
 						doskip();
+						checkpoint(CRACheckpoint::Record::Skip, D);
 					}
 					else {
 						++ngood_;
 						Builder_.initialize(D,r);
+						checkpoint(CRACheckpoint::Record::Initialize, D, r);
 					}
 #ifdef _LB_CRATIMING
                     chrono.stop();
@@ -206,20 +344,23 @@ namespace LinBox
 					case IterationResult::CONTINUE:
 						++ngood_;
 						Builder_.progress(D, r);
+						checkpoint(CRACheckpoint::Record::Progress, D, r);
 						break;
 					case IterationResult::SKIP:
 						doskip();
+						checkpoint(CRACheckpoint::Record::Skip, D);
 						break;
 					case IterationResult::RESTART:
 						commentator().report(Commentator::LEVEL_IMPORTANT,INTERNAL_WARNING) << "previous primes were bad; restarting\n";
 						nbad_ += ngood_;
 						ngood_ = 1;
 						Builder_.initialize(D, r);
+						checkpoint(CRACheckpoint::Record::Initialize, D, r);
 						break;
 					}
 				}
-
                 Builder_.result(res);
+				closeCheckpoint();
 				return ngood_ > 0 && Builder_.terminated();
             }
 
@@ -91,6 +91,14 @@ namespace LinBox
 		SparseSeqMatrix        &A,
 		PivotStrategy   reord = PivotStrategy::Linear) const;
 
+		/// With \p M.pivotStrategy (the elimination over GF2 is sequential).
+		template <class SparseSeqMatrix> size_t& rankInPlace(size_t &Rank,
+		SparseSeqMatrix        &A,
+		const MethodBase &M) const
+		{
+			return rankInPlace(Rank, A, M.pivotStrategy);
+		}
+
 		///
 		template <class SparseSeqMatrix> size_t& rank(size_t &rk,
 		const SparseSeqMatrix        &A,
@@ -117,6 +125,13 @@ namespace LinBox
 		template <class SparseSeqMatrix> Element& detInPlace(Element &determinant,
 		SparseSeqMatrix        &A,
 		PivotStrategy   reord = PivotStrategy::Linear) const;
+		/// With \p M.pivotStrategy (the elimination over GF2 is sequential).
+		template <class SparseSeqMatrix> Element& detInPlace(Element &determinant,
+		SparseSeqMatrix        &A,
+		const MethodBase &M) const
+		{
+			return detInPlace(determinant, A, M.pivotStrategy);
+		}
 		///
 		template <class SparseSeqMatrix> Element& detInPlace(Element &determinant,
 		SparseSeqMatrix        &A,
@@ -124,6 +124,10 @@ namespace LinBox
 		size_t  Ni,
 		size_t  Nj,
 		PivotStrategy   reord = PivotStrategy::Linear) const;
+		/// As selected by \p M: InPlaceParallelPivoting on M.nbThreads threads for Dispatch::SMP, else \p M.pivotStrategy.
+		template <class _Matrix> size_t& rankInPlace(size_t &rank,
+		_Matrix        &A,
+		const MethodBase &M) const;
 		//@}
 
 		/** @name det
@@ -154,6 +158,10 @@ namespace LinBox
 		size_t  Ni,
 		size_t  Nj,
 		PivotStrategy   reord = PivotStrategy::Linear) const;
+		/// As selected by \p M: InPlaceParallelPivoting on M.nbThreads threads for Dispatch::SMP, else \p M.pivotStrategy.
+		template <class _Matrix> Element& detInPlace(Element &determinant,
+		_Matrix        &A,
+		const MethodBase &M) const;
 		//@}
 
 
@@ -224,6 +232,8 @@ namespace LinBox
 
 		// Sparsest method
 		//   erases elements while computing rank/det.
+		//   Over finite fields, once the trailing matrix is denser than
+		//   LINBOX_GAUSS_DENSE_SWITCH_DENSITY, it is finished by FFPACK.
 		template <class _Matrix>
 		size_t& InPlaceLinearPivoting(size_t &rank,
 						     Element& determinant,
@@ -242,6 +252,22 @@ namespace LinBox
 						     size_t Ni,
 						     size_t Nj) const;
 
+		/** \brief Sparse in place Gaussian elimination, several pivots per step.
+		 * Each step takes a set of structurally independent pivots
+		 * (sparsest rows first, sparsest column of each row): no pivot
+		 * row has an entry in the pivot column of another one. The
+		 * remaining rows are then reduced by the whole set, in parallel
+		 * on \p threads threads (0 for all the available ones).
+		 * Rank and determinant are the ones of InPlaceLinearPivoting.
+		 */
+		template <class _Matrix>
+		size_t& InPlaceParallelPivoting(size_t &rank,
+						       Element& determinant,
+						       _Matrix        &A,
+						       size_t Ni,
+						       size_t Nj,
+						       size_t threads = 0) const;
+
 
 		/** \brief Sparse Gaussian elimination without reordering.
 
@@ -299,6 +325,17 @@ Using : FindPivot and LU
 				const long &indpermut,
 				D                   &columns) const;
 
+		//-----------------------------------------
+		// Sparse row update :
+		// lc <-- lc + headcoeff * lp
+		// construit is a workspace
+		//-----------------------------------------
+		template <class Vector>
+		void sparseAxpyin (Vector              &lignecourante,
+				   const Element       &headcoeff,
+				   const Vector        &lignepivot,
+				   Vector              &construit) const;
+
 		template <class Vector>
 		void permute (Vector              &lignecourante,
 			      const size_t &indcol,
@@ -371,6 +408,29 @@ Using : FindPivot and LU
 				      size_t Nj) const;
 
 
+		//------------------------------------------
+		// Rank/det elimination: rows k.. of LigneA
+		// (columns Rank..) are finished by a dense
+		// PLUQ. Returns false, doing nothing, over
+		// rings not handled by FFPACK.
+		//------------------------------------------
+		template <class _Matrix>
+		bool DenseContinuation(size_t &rank,
+				       Element& determinant,
+				       _Matrix	&LigneA,
+				       size_t k,
+				       size_t Ni,
+				       size_t Nj,
+				       std::true_type) const;
+		template <class _Matrix>
+		bool DenseContinuation(size_t &rank,
+				       Element& determinant,
+				       _Matrix	&LigneA,
+				       size_t k,
+				       size_t Ni,
+				       size_t Nj,
+				       std::false_type) const;
+
 		template <class _Matrix, class Perm, bool hasFFLAS>
         struct Continuation {
             size_t& operator()(
@@ -391,6 +451,7 @@ Using : FindPivot and LU
 #include "linbox/algorithms/gauss/gauss.inl"
 #include "linbox/algorithms/gauss/gauss-pivot.inl"
 #include "linbox/algorithms/gauss/gauss-elim.inl"
+#include "linbox/algorithms/gauss/gauss-parallel.inl"
 #include "linbox/algorithms/gauss/gauss-solve.inl"
 #include "linbox/algorithms/gauss/gauss-nullspace.inl"
 #include "linbox/algorithms/gauss/gauss-rank.inl"
@@ -56,6 +56,21 @@ namespace LinBox
 		return detInPlace(determinant, A,  A.rowdim (), A.coldim (), reord);
 	}
 
+	template <class _Field>
+	template <class _Matrix> inline typename GaussDomain<_Field>::Element&
+	GaussDomain<_Field>::detInPlace(Element &determinant,
+				   _Matrix  &A,
+				   const MethodBase &M)  const
+	{
+		if (M.dispatch == Dispatch::SMP) {
+			size_t Rank;
+			InPlaceParallelPivoting(Rank, determinant, A, A.rowdim (), A.coldim (),
+						M.nbThreads);
+			return determinant;
+		}
+		return detInPlace(determinant, A, M.pivotStrategy);
+	}
+
 
 
 	template <class _Field>
@@ -0,0 +1,264 @@
+/* linbox/algorithms/gauss/gauss-parallel.inl
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+// =================================================================== //
+// Right looking sparse elimination, several pivots per step
+// =================================================================== //
+
+#ifndef __LINBOX_gauss_parallel_INL
+#define __LINBOX_gauss_parallel_INL
+
+#include <vector>
+#include <algorithm>
+
+#include "linbox/matrix/matrixdomain/blas-parallelism.h"
+
+#ifndef LINBOX_GAUSS_PARALLEL_PIVOTS
+// largest number of pivots eliminated in one step
+#define LINBOX_GAUSS_PARALLEL_PIVOTS 4096
+#endif
+
+namespace LinBox
+{
+	template <class _Field>
+	template <class _Matrix> inline size_t&
+	GaussDomain<_Field>::InPlaceParallelPivoting (size_t &Rank,
+						      Element        &determinant,
+						      _Matrix         &LigneA,
+						      size_t   Ni,
+						      size_t   Nj,
+						      size_t   threads) const
+	{
+		typedef typename _Matrix::Row        Vector;
+
+		// Requirements : LigneA is an array of sparse rows
+		// In place (LigneA is modified, pivot rows are erased)
+		// Columns are not renamed: the determinant sign comes from
+		// the permutation row of a pivot -> column of this pivot.
+		commentator().start ("IPPR parallel Gaussian elimination with reordering",
+				     "IPPR", Ni);
+		const size_t t = BlasParallelism(threads).effective();
+		field().write( commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+			       << "Gaussian elimination on " << Ni << " x " << Nj << " matrix, "
+			       << t << " threads, over: ") << std::endl;
+
+		field().assign(determinant,field().one);
+		Rank = 0;
+
+		// column densities of the active rows
+		std::vector<size_t> col_density (Nj, 0);
+		std::vector<size_t> active;
+		for (size_t i = 0; i < Ni; ++i) {
+			for (size_t k = 0; k < LigneA[i].size (); ++k)
+				++col_density[LigneA[i][k].first];
+			if (LigneA[i].size ())
+				active.push_back (i);
+		}
+
+		std::vector<long>   colpiv (Nj, -1);  // column -> its pivot in the current step
+		std::vector<char>   blocked (Nj, 0);  // column holds an entry of a current pivot row
+		std::vector<size_t> pivcol (Ni, Nj);  // row -> column of its pivot
+		std::vector<size_t> prow, touched, rest;
+		std::vector<Element> pinv;
+		std::vector<char> chosen;
+
+		while (! active.empty ()) {
+			commentator().progress ((long)Rank);
+
+			// Independent pivots, sparsest rows first, sparsest column of
+			// each row: a row is taken when it has no entry in the pivot
+			// columns already taken, and its pivot column has no entry in
+			// the pivot rows already taken.
+			std::stable_sort (active.begin (), active.end (),
+					  [&LigneA](size_t a, size_t b) { return LigneA[a].size () < LigneA[b].size (); });
+			prow.resize (0); pinv.resize (0); touched.resize (0);
+			chosen.assign (active.size (), 0);
+			for (size_t a = 0; a < active.size () && prow.size () < LINBOX_GAUSS_PARALLEL_PIVOTS; ++a) {
+				Vector &lp = LigneA[active[a]];
+				long best = -1;
+				bool independent = true;
+				for (size_t j = 0; j < lp.size (); ++j) {
+					size_t c = lp[j].first;
+					if (colpiv[c] >= 0) { independent = false; break; }
+					if (!blocked[c] && (best < 0 || col_density[c] < col_density[lp[(size_t)best].first]))
+						best = (long)j;
+				}
+				if (!independent || best < 0) continue;
+
+				size_t c = lp[(size_t)best].first;
+				colpiv[c] = (long)prow.size ();
+				pivcol[active[a]] = c;
+				prow.push_back (active[a]);
+				Element inv;
+				field().mulin (determinant, lp[(size_t)best].second);
+				pinv.push_back (field().inv (inv, lp[(size_t)best].second));
+				for (size_t j = 0; j < lp.size (); ++j)
+					if (!blocked[lp[j].first]) {
+						blocked[lp[j].first] = 1;
+						touched.push_back (lp[j].first);
+					}
+				chosen[a] = 1;
+			}
+
+			rest.resize (0);
+			for (size_t a = 0; a < active.size (); ++a)
+				if (!chosen[a]) rest.push_back (active[a]);
+
+			// The pivots act on disjoint columns: each remaining row is
+			// reduced by all of them independently of the others.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,16) num_threads((int)t)
+#endif
+			for (long a = 0; a < (long)rest.size (); ++a) {
+				Vector &lc = LigneA[rest[(size_t)a]];
+				size_t nb = 0;
+				for (size_t j = 0; j < lc.size (); ++j)
+					if (colpiv[lc[j].first] >= 0) ++nb;
+				if (!nb) continue;
+
+				std::vector<std::pair<long, Element> > coefs; coefs.reserve (nb);
+				for (size_t j = 0; j < lc.size (); ++j) {
+					long i = colpiv[lc[j].first];
+					if (i < 0) continue;
+					Element coef;
+					field().neg (coef, lc[j].second);
+					field().mulin (coef, pinv[(size_t)i]);
+					coefs.push_back (std::make_pair (i, coef));
+				}
+
+				for (size_t j = 0; j < lc.size (); ++j) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+					--col_density[lc[j].first];
+				}
+				Vector construit;
+				for (size_t l = 0; l < coefs.size (); ++l)
+					sparseAxpyin (lc, coefs[l].second, LigneA[prow[(size_t)coefs[l].first]], construit);
+				for (size_t j = 0; j < lc.size (); ++j) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+					++col_density[lc[j].first];
+				}
+			}
+
+			// pivot rows leave the active part
+			Rank += prow.size ();
+			for (size_t i = 0; i < prow.size (); ++i) {
+				Vector &lp = LigneA[prow[i]];
+				for (size_t j = 0; j < lp.size (); ++j)
+					--col_density[lp[j].first];
+				colpiv[pivcol[prow[i]]] = -1;
+				Vector ().swap (lp);
+			}
+			for (size_t j = 0; j < touched.size (); ++j)
+				blocked[touched[j]] = 0;
+
+			active.resize (0);
+			for (size_t a = 0; a < rest.size (); ++a)
+				if (LigneA[rest[a]].size ())
+					active.push_back (rest[a]);
+		}
+
+		integer card;
+
+		if ((Rank < Ni) || (Rank < Nj) || (Ni == 0) || (Nj == 0))
+			field().assign(determinant,field().zero);
+		else {
+			// sign of the permutation row -> pivot column
+			std::vector<char> seen (Ni, 0);
+			size_t cycles = 0;
+			for (size_t i = 0; i < Ni; ++i) {
+				if (seen[i]) continue;
+				++cycles;
+				for (size_t j = i; !seen[j]; j = pivcol[j])
+					seen[j] = 1;
+			}
+			if ((Ni - cycles) & 1)
+				field().negin(determinant);
+		}
+
+		field().write(commentator().report (Commentator::LEVEL_NORMAL, PARTIAL_RESULT)
+			      << "Determinant : ", determinant)
+		<< " over GF (" << field().cardinality (card) << ")" << std::endl;
+
+		commentator().report (Commentator::LEVEL_NORMAL, PARTIAL_RESULT)
+		<< "Rank : " << Rank
+		<< " over GF (" << card << ")" << std::endl;
+		commentator().stop ("done", 0, "IPPR");
+		return Rank;
+	}
+
+	template <class _Field>
+	template <class Vector> inline void
+	GaussDomain<_Field>::sparseAxpyin (Vector              &lignecourante,
+					   const Element       &headcoeff,
+					   const Vector        &lignepivot,
+					   Vector              &construit) const
+	{
+		typedef typename Vector::value_type E;
+
+		const size_t nj = lignecourante.size (), npiv = lignepivot.size ();
+		construit.resize (0);
+		construit.reserve (nj + npiv);
+
+		size_t m = 0, l = 0;
+		while ((m < nj) && (l < npiv)) {
+			if (lignecourante[m].first < lignepivot[l].first)
+				construit.push_back (lignecourante[m++]);
+			else if (lignepivot[l].first < lignecourante[m].first) {
+				E e = lignepivot[l++];
+				field().mulin (e.second, headcoeff);
+				construit.push_back (e);
+			}
+			else {
+				Element tmp;
+				field().axpy (tmp, headcoeff, lignepivot[l++].second, lignecourante[m].second);
+				if (! field().isZero (tmp)) {
+					construit.push_back (lignecourante[m]);
+					field().assign (construit.back ().second, tmp);
+				}
+				++m;
+			}
+		}
+		for (; m < nj; ++m)
+			construit.push_back (lignecourante[m]);
+		for (; l < npiv; ++l) {
+			E e = lignepivot[l];
+			field().mulin (e.second, headcoeff);
+			construit.push_back (e);
+		}
+		lignecourante.swap (construit);
+	}
+
+} // namespace LinBox
+
+#endif // __LINBOX_gauss_parallel_INL
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
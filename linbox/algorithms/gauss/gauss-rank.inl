@@ -55,6 +55,20 @@ namespace LinBox
 		return rankInPlace(Rank, A,  A.rowdim (), A.coldim (), reord);
 	}
 
+	template <class _Field>
+	template <class _Matrix> size_t&
+	GaussDomain<_Field>::rankInPlace(size_t &Rank,
+				    _Matrix        &A,
+				    const MethodBase &M)  const
+	{
+		if (M.dispatch == Dispatch::SMP) {
+			Element determinant;
+			return InPlaceParallelPivoting(Rank, determinant, A, A.rowdim (), A.coldim (),
+						       M.nbThreads);
+		}
+		return rankInPlace(Rank, A, M.pivotStrategy);
+	}
+
 
 
 	template <class _Field>
@@ -45,8 +45,9 @@
 #define __LINBOX_FILLIN__
 #endif
 
-#ifdef __LINBOX_SpD_SWITCH__
 #include <linbox/matrix/dense-matrix.h>
+
+#ifdef __LINBOX_SpD_SWITCH__
 #include <numeric>
 #  ifndef __LINBOX_SpD_MAXSPARSITY__
 // Sparsity less than 1% --> switch to dense
@@ -54,6 +55,17 @@
 #  endif
 #endif
 
+#ifndef LINBOX_GAUSS_DENSE_SWITCH_DENSITY
+// Rank/det elimination: trailing density above which the remaining rows are
+// finished by FFPACK (a value above 1 disables the switch)
+#define LINBOX_GAUSS_DENSE_SWITCH_DENSITY 0.1
+#endif
+
+#ifndef LINBOX_GAUSS_DENSE_SWITCH_MAXENTRIES
+// largest trailing matrix (in entries) stored densely
+#define LINBOX_GAUSS_DENSE_SWITCH_MAXENTRIES (size_t(1)<<27)
+#endif
+
 namespace LinBox
 {
     template <class _Field>
@@ -485,6 +497,59 @@ namespace LinBox
     }
 
 
+    template <class _Field>
+    template <class _Matrix> inline bool
+    GaussDomain<_Field>::DenseContinuation (size_t &Rank,
+                                            Element        &determinant,
+                                            _Matrix         &LigneA,
+                                            size_t k,
+                                            size_t Ni,
+                                            size_t Nj,
+                                            std::true_type) const
+    {
+        typedef typename _Matrix::Row        Vector;
+
+        // rows k..Ni-1 only have entries in columns Rank..Nj-1
+        const size_t sNi = Ni - k, sNj = Nj - Rank;
+        commentator().report (Commentator::LEVEL_NORMAL, INTERNAL_DESCRIPTION)
+        << "Dense switch: " << sNi << 'x' << sNj << " trailing matrix" << std::endl;
+
+        BlasMatrix<_Field> A(this->field(), sNi, sNj);
+        for (size_t di = k; di < Ni; ++di) {
+            for (size_t dj = 0; dj < LigneA[di].size (); ++dj)
+                A.setEntry(di-k, LigneA[di][dj].first-Rank, LigneA[di][dj].second);
+            Vector ().swap (LigneA[di]);
+        }
+
+        size_t *P2 = FFLAS::fflas_new<size_t>(sNi);
+        size_t *Q2 = FFLAS::fflas_new<size_t>(sNj);
+        size_t R2 = FFPACK::PLUQ(this->field(), FFLAS::FflasNonUnit, sNi, sNj,
+                                 A.getPointer(), A.getStride(), P2, Q2);
+
+        // det(S) = det(P2) det(U2) det(Q2); only used when S is square of full rank
+        for (size_t i = 0; i < R2; ++i)
+            this->field().mulin(determinant, A.getEntry(i,i));
+        for (size_t i = 0; i < sNi; ++i)
+            if (P2[i] != i) this->field().negin(determinant);
+        for (size_t j = 0; j < sNj; ++j)
+            if (Q2[j] != j) this->field().negin(determinant);
+
+        FFLAS::fflas_delete(P2);
+        FFLAS::fflas_delete(Q2);
+        Rank += R2;
+        return true;
+    }
+
+    template <class _Field>
+    template <class _Matrix> inline bool
+    GaussDomain<_Field>::DenseContinuation (size_t &, Element &, _Matrix &,
+                                            size_t, size_t, size_t,
+                                            std::false_type) const
+    {
+        // no FFPACK elimination over this ring: stay sparse
+        return false;
+    }
+
     template <class _Field>
     template <class _Matrix> inline size_t&
     GaussDomain<_Field>::InPlaceLinearPivoting (size_t &Rank,
@@ -522,6 +587,7 @@ namespace LinBox
         const long last = (long)Ni - 1;
         long c;
         Rank = 0;
+        bool densed = false;
 
 #ifdef __LINBOX_OFTEN__
         long sstep = last/40;
@@ -555,16 +621,27 @@ namespace LinBox
 #endif
 
             if (s) {
-                size_t l;
+                size_t l, nnz = (size_t)s;
                 // Row permutation for the sparsest row
                 for (l = (size_t)k + 1; l < (size_t)Ni; ++l) {
                 long sl;
-                    if (((sl = (long)LigneA[(size_t)l].size ()) < s) && (sl)) {
+                    nnz += (size_t)(sl = (long)LigneA[(size_t)l].size ());
+                    if ((sl < s) && (sl)) {
                         s = sl;
                         p = (long)l;
                     }
                 }
 
+                // Dense trailing matrix: finished by FFPACK
+                const size_t tNi = Ni - (size_t)k, tNj = Nj - Rank;
+                if ((double)nnz >= LINBOX_GAUSS_DENSE_SWITCH_DENSITY * (double)tNi * (double)tNj
+                    && tNi * tNj <= LINBOX_GAUSS_DENSE_SWITCH_MAXENTRIES
+                    && DenseContinuation (Rank, determinant, LigneA, (size_t)k, Ni, Nj,
+                                          std::integral_constant<bool, std::is_base_of<Givaro::FiniteRingInterface<Element>,_Field>::value>())) {
+                    densed = true;
+                    break;
+                }
+
                 if (p != k) {
                     field().negin(determinant);
                     Vector vtm = LigneA[(size_t)k];
@@ -590,7 +667,8 @@ namespace LinBox
 
         }//for k
 
-        SparseFindPivot (LigneA[(size_t)last], Rank, c, determinant);
+        if (! densed)
+            SparseFindPivot (LigneA[(size_t)last], Rank, c, determinant);
 
 #ifdef __LINBOX_COUNT__
         nbelem += LigneA[(size_t)last].size ();
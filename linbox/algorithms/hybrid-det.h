@@ -38,6 +38,7 @@
 #include "linbox/algorithms/cra-domain.h"
 #include "linbox/randiter/random-prime.h"
 #include "linbox/algorithms/matrix-hom.h"
+#include "linbox/blackbox/modular-csr-view.h"
 #include "linbox/solutions/det.h"
 
 // #define _LB_H_DET_TIMING
@@ -60,6 +61,25 @@ namespace LinBox
 		size_t                       iter_count2;
 		typedef  BlasVector<Givaro::ZRing<Integer> >  IVect ;
 		IVect                            moduli ;
+		IntegerCSRImage                        I ; //!< shared word size copy of A, when it can be reduced on apply
+		typedef UseModularCSRView<Blackbox,MyMethod> ReduceOnApply;
+
+		template<typename Field>
+		void detImage(typename Field::Element& d, const Field& F, std::false_type)
+		{
+			typedef typename Blackbox::template rebind<Field>::other FBlackbox;
+			FBlackbox Ap(A,F);
+			detInPlace( d, Ap, M);
+		}
+
+		template<typename Field>
+		void detImage(typename Field::Element& d, const Field& F, std::true_type)
+		{
+			if (! I.fits())
+				return detImage(d, F, std::false_type());
+			ModularCSRView<Field> Ap(I, F);
+			detInPlace( d, Ap, M);
+		}
 
 	public:
 
@@ -87,6 +107,7 @@ namespace LinBox
 			// primes.resize(factor);
 			iter_count = 0;
 			iter_count2 = 0;
+			initCSRImage(I, A, ReduceOnApply());
 
 		}
 
@@ -109,9 +130,7 @@ namespace LinBox
 				}
 			}
 
-			typedef typename Blackbox::template rebind<Field>::other FBlackbox;
-			FBlackbox Ap(A,F);
-			detInPlace( d, Ap, M);
+			detImage(d, F, ReduceOnApply());
 
 			if (beta > 1) {
 				typename Field::Element y;
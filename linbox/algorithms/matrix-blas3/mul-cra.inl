@@ -27,6 +27,7 @@
 
 #include "linbox/algorithms/cra-domain.h"
 #include "linbox/algorithms/cra-builder-full-multip-fixed.h"
+#include "linbox/algorithms/rns-image-cache.h"
 
 #include "givaro/random-integer.h"
 #include "linbox/randiter/random-prime.h"
@@ -51,13 +52,14 @@ namespace LinBox { namespace BLAS3 { namespace Protected {
 #endif
 
 		const IntegerMatrix &_A_, &_B_;
+		MultiModImageCache<IntegerMatrix> _cacheA, _cacheB;
 
 #ifdef _LB_MM_TIMING
 		mutable Mytime chrono;
 #endif
 
 		IntegerCraMatMul(const IntegerMatrix& A, const IntegerMatrix& B) :
-			_A_(A), _B_(B)
+			_A_(A), _B_(B), _cacheA(A), _cacheB(B)
 		{
 #ifdef _LB_MM_TIMING
 			chrono.clear();
@@ -66,7 +68,7 @@ namespace LinBox { namespace BLAS3 { namespace Protected {
 		}
 
 		IntegerCraMatMul(IntegerMatrix& A, IntegerMatrix& B) :
-			_A_(A), _B_(B)
+			_A_(A), _B_(B), _cacheA(A), _cacheB(B)
 		{
 #ifdef _LB_MM_TIMING
 			chrono.clear();
@@ -74,15 +76,26 @@ namespace LinBox { namespace BLAS3 { namespace Protected {
 			linbox_check(A.getPointer() == _A_.getPointer());
 		}
 
+		/*! Reduces A and B modulo a whole batch of primes at once.
+		 * Called by PrefetchPrimeIterator, before the primes are used.
+		 */
+		template<class PrimeVector>
+		void prefetch(const PrimeVector& primes)
+		{
+			_cacheA.reduce(primes);
+			_cacheB.reduce(primes);
+		}
+
 		IterationResult operator()(ModularMatrix& Cp, const Field& F) const
 		{
 			BlasMatrixDomain<Field>   BMD(F);
 
 			/*  intialisation */
-			// ModularMatrix Cpp(_A_.rowdim(),_B_.coldim());
-			// Cp = Cpp ;
-			ModularMatrix Ap(_A_, F);
-			ModularMatrix Bp(_B_, F);
+			// images are fetched from the batch caches when possible
+			ModularMatrix Ap(F, _A_.rowdim(), _A_.coldim());
+			ModularMatrix Bp(F, _B_.rowdim(), _B_.coldim());
+			_cacheA.image(Ap, F);
+			_cacheB.image(Bp, F);
 			Cp.resize(Ap.rowdim(),Bp.coldim());
 
 			/*  multiplication mod p */
@@ -146,10 +159,19 @@ namespace LinBox { namespace BLAS3 {
 
 		{
 
-                        PrimeIterator<IteratorCategories::HeuristicTag> genprime(FieldTraits<ModularField>::bestBitSize(A.coldim()));
+                        PrimeIterator<IteratorCategories::HeuristicTag> genbase(FieldTraits<ModularField>::bestBitSize(A.coldim()));
 			ChineseRemainder< CRABuilderFullMultipMatrix< ModularField > > cra( std::pair<size_t,double>(C.rowdim()*C.coldim(), logC) );
 			Protected::IntegerCraMatMul iteration(A,B);
 
+			// Number of primes reduced at once: roughly what the
+			// reconstruction needs, at least one round of CRA threads.
+			size_t batch = (size_t)(logC / ((double)genbase.getBits()*std::log(2.))) + 1;
+#ifdef LINBOX_USES_OPENMP
+			batch = std::max(batch, (size_t)omp_get_max_threads());
+#endif
+			batch = std::min(batch, (size_t)64);
+			PrefetchPrimeIterator<PrimeIterator<IteratorCategories::HeuristicTag>, Protected::IntegerCraMatMul> genprime(genbase, iteration, batch);
+
 			cra(C, iteration, genprime);
 
 #ifdef _LB_DEBUG
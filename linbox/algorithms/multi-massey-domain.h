@@ -0,0 +1,293 @@
+/* linbox/algorithms/multi-massey-domain.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/multi-massey-domain.h
+ * @ingroup algorithms
+ * @brief Berlekamp/Massey on several scalar projections at once.
+ *
+ * The \f$k\f$ sequences \f$u_j^T A^i v\f$ share their Krylov vectors: each
+ * apply of \f$A\f$ feeds \f$k\f$ dot products. Berlekamp/Massey runs
+ * incrementally on every sequence, the \f$k\f$ updates being done in
+ * parallel, and the computation stops as soon as the \f$k\f$ generators
+ * agree and none of them changed for \c EARLY_TERM_THRESHOLD steps.
+ * Should they still differ at the end of the sequence, their least common
+ * multiple is returned.
+ */
+
+#ifndef __LINBOX_multi_massey_domain_H
+#define __LINBOX_multi_massey_domain_H
+
+#include <vector>
+
+#include "linbox/util/commentator.h"
+#include "linbox/vector/blas-vector.h"
+#include "linbox/vector/vector-domain.h"
+#include "linbox/algorithms/massey-domain.h"
+
+namespace LinBox
+{
+
+	/** \brief Early terminated Wiedemann with several simultaneous projections.
+	 *
+	 * Same probabilistic guarantees as running MasseyDomain on \p k
+	 * independent left projections, for the cost of a single Krylov
+	 * sequence of the blackbox.
+	 */
+	template<class Field, class Blackbox>
+	class MultiMasseyDomain {
+	public:
+		typedef typename Field::Element Element;
+
+	protected:
+		/// Incremental Berlekamp/Massey on one scalar sequence.
+		struct Generator {
+			std::vector<Element> C, B; // reversed connection polynomials
+			Element b;
+			long L, x;
+
+			Generator(const Field& F) :
+				C(1,F.one), B(1,F.one), b(F.one), L(0), x(1)
+			{}
+
+			// Processes S[N]; returns true if C changed.
+			bool step(const Field& F, const std::vector<Element>& S, long N)
+			{
+				Element d = S[(size_t)N];
+				for (long i = 1; i <= L && i < (long)C.size(); ++i)
+					F.axpyin(d, C[(size_t)i], S[(size_t)(N-i)]);
+				if (F.isZero(d)) {
+					++x;
+					return false;
+				}
+				Element Ds;
+				F.divin(F.neg(Ds, d), b);
+				if (2*L > N) {
+					addShifted(F, Ds);
+					++x;
+				}
+				else {
+					std::vector<Element> T(C);
+					addShifted(F, Ds);
+					L = N+1-L;
+					B.swap(T);
+					b = d;
+					x = 1;
+				}
+				return true;
+			}
+
+			// C = C + Ds . X^x . B
+			void addShifted(const Field& F, const Element& Ds)
+			{
+				if (C.size() < B.size()+(size_t)x)
+					C.resize(B.size()+(size_t)x, F.zero);
+				for (size_t i = 0; i < B.size(); ++i)
+					F.axpyin(C[i+(size_t)x], Ds, B[i]);
+			}
+
+			long degree(const Field& F) const
+			{
+				long i = (long)C.size()-1;
+				while (i >= 0 && F.isZero(C[(size_t)i])) --i;
+				return i;
+			}
+
+			long valuation(const Field& F) const
+			{
+				long i = 0;
+				while (i < (long)C.size() && F.isZero(C[(size_t)i])) ++i;
+				return i;
+			}
+
+			bool areEqual(const Field& F, const Generator& G) const
+			{
+				if (L != G.L) return false;
+				long d = degree(F);
+				if (d != G.degree(F)) return false;
+				for (long i = 0; i <= d; ++i)
+					if (! F.areEqual(C[(size_t)i], G.C[(size_t)i])) return false;
+				return true;
+			}
+		};
+
+		typedef std::vector<Element> Poly; // increasing degrees
+
+		// minimal polynomial of the sequence of G, monic of degree G.L
+		static Poly reversed(const Field& F, const Generator& G)
+		{
+			const size_t dp = (size_t)G.L;
+			Poly P(dp+1);
+			for (size_t i = 0; i <= dp; ++i)
+				F.assign(P[i], (dp-i < G.C.size()) ? G.C[dp-i] : F.zero);
+			return P;
+		}
+
+		static void normalize(const Field& F, Poly& A)
+		{
+			while (! A.empty() && F.isZero(A.back())) A.pop_back();
+		}
+
+		// A = Q B + R, B nonzero
+		static void divRem(const Field& F, Poly& Q, Poly& R, const Poly& A, const Poly& B)
+		{
+			R = A;
+			normalize(F, R);
+			const size_t db = B.size()-1;
+			Q.assign((R.size() > db) ? R.size()-db : 0, F.zero);
+			Element inv, c;
+			F.inv(inv, B.back());
+			while (R.size() > db) {
+				const size_t s = R.size()-1-db;
+				F.mul(c, R.back(), inv);
+				Q[s] = c;
+				for (size_t i = 0; i <= db; ++i)
+					F.maxpyin(R[s+i], c, B[i]);
+				R.pop_back();
+				normalize(F, R);
+			}
+		}
+
+		static Poly lcm(const Field& F, const Poly& A, const Poly& B)
+		{
+			Poly U(A), V(B), Q, R;
+			normalize(F, U); normalize(F, V);
+			while (! V.empty()) {
+				divRem(F, Q, R, U, V);
+				U.swap(V); V.swap(R);
+			}
+			divRem(F, Q, R, B, U);
+			Poly P(A.size()+Q.size()-1, F.zero);
+			for (size_t i = 0; i < A.size(); ++i)
+				for (size_t j = 0; j < Q.size(); ++j)
+					F.axpyin(P[i+j], A[i], Q[j]);
+			Element inv;
+			F.inv(inv, P.back());
+			for (auto& p : P) F.mulin(p, inv);
+			return P;
+		}
+
+		const Blackbox *_BB;
+		const Field    *_field;
+		size_t              _k;
+		size_t EARLY_TERM_THRESHOLD;
+
+	public:
+		/** Constructor.
+		 * @param A   square blackbox
+		 * @param F   field
+		 * @param k   number of simultaneous projections
+		 * @param ett number of steps the \p k generators must agree before termination
+		 */
+		MultiMasseyDomain(const Blackbox *A, const Field &F, size_t k,
+				  size_t ett = LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD) :
+			_BB(A), _field(&F), _k(k ? k : 1), EARLY_TERM_THRESHOLD(ett)
+		{}
+
+		const Field &field() const { return *_field; }
+
+		/** Minimal polynomial of the blackbox, from random projections.
+		 * @param[out] phi monic minimal polynomial, in increasing degrees:
+		 * the least common multiple of the \p k generators, reported as a
+		 * warning when they do not agree
+		 * @param[out] rank as given by the generator (degree minus valuation)
+		 * @param g random iterator for the projections
+		 * @return number of sequence elements used
+		 */
+		template<class Polynomial, class RandIter>
+		long minpoly(Polynomial &phi, size_t &rank, RandIter& g)
+		{
+			const Field& F = field();
+			const long n = (long)_BB->coldim();
+			const long END = 2*n + DEFAULT_ADDITIONAL_ITERATION;
+			VectorDomain<Field> VD(F);
+
+			commentator().start ("Multi projection Massey", "mmassey", (unsigned int)END);
+
+			std::vector<BlasVector<Field> > U(_k, BlasVector<Field>(F, (size_t)n));
+			for (size_t j = 0; j < _k; ++j)
+				for (long i = 0; i < n; ++i)
+					g.random(U[j][(size_t)i]);
+			BlasVector<Field> v(F, (size_t)n), w(F, (size_t)n);
+			for (long i = 0; i < n; ++i)
+				g.random(v[(size_t)i]);
+
+			std::vector<std::vector<Element> > S(_k, std::vector<Element>((size_t)END, F.zero));
+			std::vector<Generator> Gens(_k, Generator(F));
+
+			long N = 0;
+			size_t stable = 0;
+			bool agree = false;
+			for (; N < END && stable < EARLY_TERM_THRESHOLD; ++N) {
+				if (N > 0) {
+					_BB->apply(w, v);
+					std::swap(v, w);
+				}
+				bool changed = false;
+#ifdef __LINBOX_USE_OPENMP
+#pragma omp parallel for reduction(||:changed)
+#endif
+				for (long j = 0; j < (long)_k; ++j) {
+					VD.dot(S[(size_t)j][(size_t)N], U[(size_t)j], v);
+					changed = Gens[(size_t)j].step(F, S[(size_t)j], N) || changed;
+				}
+
+				agree = ! changed;
+				for (size_t j = 1; agree && j < _k; ++j)
+					agree = Gens[j].areEqual(F, Gens[0]);
+				stable = agree ? stable+1 : 0;
+			}
+
+			for (size_t j = 1; j < _k; ++j)
+				agree = agree && Gens[j].areEqual(F, Gens[0]);
+
+			Poly P = reversed(F, Gens[0]);
+			if (! agree) {
+				commentator().report (Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+					<< "the " << _k << " generators do not agree after " << N
+					<< " steps, returning their least common multiple" << std::endl;
+				for (size_t j = 1; j < _k; ++j)
+					P = lcm(F, P, reversed(F, Gens[j]));
+			}
+
+			commentator().stop ("done", NULL, "mmassey");
+
+			size_t val = 0;
+			while (val < P.size() && F.isZero(P[val])) ++val;
+			rank = P.size()-1-val;
+			phi.resize(P.size());
+			for (size_t i = 0; i < P.size(); ++i)
+				F.assign(phi[i], P[i]);
+			return N;
+		}
+	};
+
+}
+
+#endif // __LINBOX_multi_massey_domain_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,307 @@
+/* linbox/algorithms/multimod-wiedemann.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/multimod-wiedemann.h
+ * @ingroup algorithms
+ * @brief Wiedemann minpoly and determinant modulo several primes, sharing the applies.
+ *
+ * The \c k Krylov sequences \f$u_l^T A^i w_l \bmod p_l\f$ are computed in
+ * lockstep by a MultiModCSRView, so that the matrix is read once per
+ * step for all the primes. Each sequence is then handed to its own
+ * MasseyDomain. The terms are kept, so that a sequence needing more
+ * terms than the previous ones extends all of them.
+ */
+
+#ifndef __LINBOX_multimod_wiedemann_H
+#define __LINBOX_multimod_wiedemann_H
+
+#include <algorithm>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/commentator.h"
+#include "linbox/vector/blas-vector.h"
+#include "linbox/field/multimod-field.h"
+#include "linbox/blackbox/multimod-csr-view.h"
+#include "linbox/algorithms/massey-domain.h"
+#include "linbox/algorithms/cra-domain.h"
+
+#ifndef LINBOX_MULTIMOD_DET_TRIES
+// preconditioners tried for a prime before it is skipped
+#define LINBOX_MULTIMOD_DET_TRIES 4
+#endif
+
+namespace LinBox
+{
+
+	/** \brief The scalar sequences \f$u_l^T (AD)^i w_l \bmod p_l\f$ of all the primes of a MultiModCSRView.
+	 *
+	 * \c u and \c w are random, \c D is an optional diagonal preconditioner.
+	 * Terms are computed on demand, for all the primes at once.
+	 */
+	class MultiModKrylovSequence {
+	public:
+		typedef MultiModCSRView::PackedVector PackedVector;
+
+		/** \p diag, when not null, is the packed diagonal of the
+		 * preconditioner, and must outlive the sequence.
+		 */
+		MultiModKrylovSequence (const MultiModCSRView& B, const PackedVector* diag = nullptr) :
+			_B(&B), _diag(diag), _k(B.moduli()), _n(B.coldim()),
+			_u(_n*_k), _w(_n*_k), _v(_n*_k), _applies(0)
+		{
+			linbox_check(B.rowdim() == B.coldim());
+			for (size_t l = 0; l < _k; ++l) {
+				Givaro::Modular<double>::RandIter G(B.field().getBase(l));
+				for (size_t j = 0; j < _n; ++j) {
+					G.random(_u[j*_k+l]);
+					G.random(_w[j*_k+l]);
+				}
+			}
+		}
+
+		//! The \p i -th term modulo the \p l -th prime, in [0, p_l).
+		double term (size_t i, size_t l)
+		{
+			while (_terms.size() <= i*_k+l)
+				next();
+			return _terms[i*_k+l];
+		}
+
+		//! Length of the sequences needed by a Berlekamp/Massey.
+		long size () const { return (long)(2*_n); }
+
+		size_t moduli () const { return _k; }
+
+		//! Number of applies of the matrix so far, for all the primes.
+		size_t applies () const { return _applies; }
+
+		/** \brief The sequence modulo one prime, as a Sequence of MasseyDomain.
+		 */
+		template<class Field>
+		class Projection {
+		public:
+			typedef typename Field::Element Element;
+
+			Projection (MultiModKrylovSequence& S, size_t l, const Field& F) :
+				_S(&S), _l(l), _field(&F)
+			{}
+
+			class const_iterator {
+			public:
+				const_iterator () : _p(0), _i(0) {}
+				const_iterator (const Projection& P) : _p(&P), _i(0) {}
+
+				const_iterator& operator++ () { ++_i; return *this; }
+
+				const Element& operator* ()
+				{
+					return _p->field().init(_e, _p->_S->term(_i, _p->_l));
+				}
+
+			protected:
+				const Projection *_p;
+				size_t            _i;
+				Element           _e;
+			};
+
+			const_iterator begin () const { return const_iterator(*this); }
+			long size () const { return _S->size(); }
+			const Field& field () const { return *_field; }
+
+		protected:
+			MultiModKrylovSequence *_S;
+			size_t                  _l;
+			const Field        *_field;
+		};
+
+	protected:
+		const MultiModCSRView *_B;
+		const PackedVector *_diag;
+		size_t _k, _n;
+		PackedVector _u, _w, _v;
+		std::vector<double> _terms, _dot;
+		size_t _applies;
+
+		//! Appends the next term of all the sequences.
+		void next ()
+		{
+			if (! _terms.empty()) {
+				if (_diag) _B->scalein(_w, *_diag, _n);
+				_B->apply(_v, _w);
+				std::swap(_v, _w);
+				++_applies;
+			}
+			_B->dot(_dot, _u, _w, _n);
+			_terms.insert(_terms.end(), _dot.begin(), _dot.end());
+		}
+	};
+
+	//! Whether the characteristics of \p F are small enough for a MultiModDouble.
+	template<class Field>
+	bool multiModFits (const std::vector<Field>& F)
+	{
+		integer c, bound(MultiModDouble::maxCardinality());
+		for (size_t l = 0; l < F.size(); ++l)
+			if (F[l].characteristic(c) > bound)
+				return false;
+		return true;
+	}
+
+	/** \brief Minimal polynomials of the image \p I modulo each prime of \p F.
+	 *
+	 * \p P[l] is the minimal polynomial modulo the characteristic of \p F[l],
+	 * with high probability, as computed by minpoly() with Method::Wiedemann.
+	 * The matrix must be square and the characteristics at most
+	 * MultiModDouble::maxCardinality().
+	 *
+	 * \p results[l] is IterationResult::SKIP when \p P[l] is shorter than
+	 * the minimal polynomial of another prime: its projection was unlucky,
+	 * or the prime is bad. It is IterationResult::CONTINUE otherwise.
+	 */
+	template<class Polynomial, class Field>
+	std::vector<IterationResult>& multiModMinpoly (std::vector<IterationResult>& results,
+						       std::vector<Polynomial>& P, const std::vector<Field>& F,
+						       const IntegerCSRImage& I,
+						       size_t earlyTermination = LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD)
+	{
+		commentator().start ("Multi-modular Wiedemann minimal polynomial", "mmminpoly");
+
+		std::vector<integer> primes(F.size());
+		for (size_t l = 0; l < F.size(); ++l)
+			F[l].characteristic(primes[l]);
+		MultiModDouble M(primes);
+		MultiModCSRView B(I, M);
+		MultiModKrylovSequence S(B);
+
+		for (size_t l = 0; l < F.size(); ++l) {
+			typedef MultiModKrylovSequence::Projection<Field> Sequence;
+			Sequence T(S, l, F[l]);
+			MasseyDomain<Field, Sequence> WD(&T, earlyTermination);
+			size_t deg;
+			WD.minpoly(P[l], deg);
+		}
+
+		size_t longest = 0;
+		for (size_t l = 0; l < F.size(); ++l)
+			longest = std::max(longest, (size_t)P[l].size());
+		results.resize(F.size());
+		for (size_t l = 0; l < F.size(); ++l)
+			results[l] = (P[l].size() < longest) ? IterationResult::SKIP : IterationResult::CONTINUE;
+
+		commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_DESCRIPTION)
+			<< S.applies() << " applies for " << F.size() << " primes" << std::endl;
+		commentator().stop ("done", NULL, "mmminpoly");
+		return results;
+	}
+
+	/** \brief Determinants of the image \p I modulo each prime of \p F.
+	 *
+	 * As det() with Method::Wiedemann: the minimal polynomial of \f$AD\f$,
+	 * \c D a random nonsingular diagonal, is its characteristic polynomial
+	 * with high probability; the primes for which it is not are tried
+	 * again together.
+	 *
+	 * \p results[l] is IterationResult::SKIP when no preconditioner worked
+	 * for the \p l -th prime in LINBOX_MULTIMOD_DET_TRIES tries, and
+	 * IterationResult::CONTINUE otherwise.
+	 */
+	template<class Field>
+	std::vector<IterationResult>& multiModDet (std::vector<IterationResult>& results,
+						   std::vector<typename Field::Element>& d, const std::vector<Field>& F,
+						   const IntegerCSRImage& I,
+						   size_t earlyTermination = LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD)
+	{
+		commentator().start ("Multi-modular Wiedemann determinant", "mmdet");
+
+		const size_t n = I.coldim();
+		std::vector<size_t> todo, again;
+		for (size_t l = 0; l < F.size(); ++l)
+			todo.push_back(l);
+		results.assign(F.size(), IterationResult::CONTINUE);
+
+		for (size_t tries = 0; ! todo.empty(); ++tries) {
+			if (tries == LINBOX_MULTIMOD_DET_TRIES) {
+				for (size_t l : todo)
+					results[l] = IterationResult::SKIP;
+				break;
+			}
+			const size_t k = todo.size();
+			std::vector<integer> primes(k);
+			for (size_t l = 0; l < k; ++l)
+				F[todo[l]].characteristic(primes[l]);
+			MultiModDouble M(primes);
+			MultiModCSRView B(I, M);
+
+			MultiModKrylovSequence::PackedVector diag(n*k);
+			std::vector<double> pi(k, 1.);
+			for (size_t l = 0; l < k; ++l) {
+				const Givaro::Modular<double>& Fl = M.getBase(l);
+				Givaro::Modular<double>::RandIter G(Fl);
+				for (size_t j = 0; j < n; ++j) {
+					do G.random(diag[j*k+l]); while (Fl.isZero(diag[j*k+l]));
+					Fl.mulin(pi[l], diag[j*k+l]);
+				}
+			}
+			MultiModKrylovSequence S(B, &diag);
+
+			again.clear();
+			for (size_t l = 0; l < k; ++l) {
+				const Field& Fl = F[todo[l]];
+				typedef MultiModKrylovSequence::Projection<Field> Sequence;
+				Sequence T(S, l, Fl);
+				MasseyDomain<Field, Sequence> WD(&T, earlyTermination);
+				BlasVector<Field> phi(Fl);
+				size_t deg;
+				WD.minpoly(phi, deg);
+
+				if ((phi.size() < n + 1) && ! Fl.isZero(phi[0])) {
+					again.push_back(todo[l]);
+					continue;
+				}
+
+				typename Field::Element p;
+				Fl.init(p, pi[l]);
+				Fl.div(d[todo[l]], phi[0], p);
+				if ((deg & 1) == 1)
+					Fl.negin(d[todo[l]]);
+			}
+			todo.swap(again);
+		}
+
+		commentator().stop ("done", NULL, "mmdet");
+		return results;
+	}
+
+}
+
+#endif // __LINBOX_multimod_wiedemann_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -3,8 +3,13 @@
 /* by Alex Stachnik
 */
 
+#include <vector>
+#include <type_traits>
 #include <givaro/extension.h>
+#include <givaro/modular.h>
 #include <linbox/algorithms/poly-interpolation.h>
+#include <linbox/algorithms/batched-elimination.h>
+#include <linbox/algorithms/polynomial-matrix/polynomial-fft-transform.h>
 #include <linbox/solutions/det.h>
 
 namespace LinBox {
@@ -73,6 +78,107 @@ computePolyDet(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element& result,
 	return result;
 }
 
+/*
+FFT variant of computePolyDet, for prime fields with word size elements.
+
+The points are the N-th roots of unity, N >= d being a power of two:
+every entry is evaluated at all of them by one forward FFT (entries of
+degree N or more are first folded modulo x^N - 1), the N determinants
+are computed together by BatchedEliminationDomain on contiguous
+m x m slices of one array, and the determinant is recovered by one
+inverse FFT. The evaluations and the determinants are shared between
+the threads.
+
+Returns false, leaving result untouched, when the characteristic is
+not an FFT prime with N | p-1, in which case computePolyDet applies.
+ */
+/// Residue in [0,p) of a machine word element, which may be negative in balanced fields.
+template <class Element>
+inline uint64_t polyDetResidue(const Element& e, uint64_t p)
+{
+	const int64_t v = (int64_t)e % (int64_t)p;
+	return (uint64_t)(v < 0 ? v + (int64_t)p : v);
+}
+
+template <class Field, class Matrix>
+bool computePolyDetFFT(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element& result,
+		       const Field& F, const Matrix& A, size_t d, std::true_type)
+{
+	typedef Givaro::Poly1Dom<Field,Givaro::Dense> PolyDom;
+	typedef typename PolyDom::Element PolyElt;
+	typedef typename Field::Element FieldElt;
+	typedef Givaro::Modular<uint32_t> QField;
+	typedef FFT_transform<QField> Transform;
+	typedef typename Transform::VECT VECT;
+
+	integer c, q; F.characteristic(c); F.cardinality(q);
+	size_t lpts=1, N=2;
+	while (N < d) { N <<= 1; ++lpts; }
+	if (c != q || c.bitsize() > 29 || ((uint64_t)c-1) % N != 0)
+		return false;
+
+	const uint64_t p = (uint64_t)c;
+	const size_t m = A.rowdim();
+	linbox_check(A.coldim() == m);
+
+	QField Q((uint32_t)p);
+	Transform FFTer(Q, lpts);
+	Transform FFTinv(Q, lpts, FFTer.getInvRoot());
+
+	// point k is the m x m matrix vals[k*m*m ... (k+1)*m*m-1]
+	std::vector<FieldElt> vals(N*m*m);
+#pragma omp parallel for schedule(dynamic)
+	for (long ij=0;ij<(long)(m*m);++ij) {
+		PolyElt e;
+		A.getEntry(e,(size_t)ij/m,(size_t)ij%m);
+		VECT buf(N,0);
+		for (size_t k=0;k<e.size();++k)
+			buf[k%N]=(uint32_t)(((uint64_t)buf[k%N]+polyDetResidue(e[k],p))%p);
+		FFTer.FFT_DIF_Harvey(buf.data());
+		for (size_t k=0;k<N;++k)
+			F.init(vals[k*m*m+(size_t)ij],(uint64_t)buf[k]);
+	}
+
+	commentator().report(Commentator::LEVEL_IMPORTANT,PROGRESS_REPORT)
+		<< "Finished FFT evaluations" << std::endl;
+
+	std::vector<FieldElt> detk;
+	BatchedEliminationDomain<Field>(F).det(detk,vals.data(),m,N);
+	VECT dets(N);
+	for (size_t k=0;k<N;++k)
+		dets[k]=(uint32_t)polyDetResidue(detk[k],p);
+
+	commentator().report(Commentator::LEVEL_IMPORTANT,PROGRESS_REPORT)
+		<< "Finished determinants" << std::endl;
+
+	FFTinv.FFT_DIT_Harvey(dets.data());
+	uint32_t invN;
+	Q.init(invN,(uint64_t)N);
+	Q.invin(invN);
+	PolyDom BR(F);
+	result.resize(N);
+	for (size_t k=0;k<N;++k)
+		F.init(result[k],(uint64_t)dets[k]*invN%p);
+	BR.setdegree(result);
+	return true;
+}
+
+template <class Field, class Matrix>
+bool computePolyDetFFT(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element&,
+		       const Field&, const Matrix&, size_t, std::false_type)
+{
+	return false;
+}
+
+/// FFT variant, when the elements of Field are machine words.
+template <class Field, class Matrix>
+bool computePolyDetFFT(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element& result,
+		       const Field& F, const Matrix& A, size_t d)
+{
+	return computePolyDetFFT(result,F,A,d,
+		typename std::is_arithmetic<typename Field::Element>::type());
+}
+
 int roundUpPowerOfTwo(unsigned int n)
 {
 	if (n==0) {
@@ -128,6 +234,9 @@ computePolyDetExtension(typename Givaro::Poly1Dom<Field,Givaro::Dense>::Element&
 	commentator().report(Commentator::LEVEL_IMPORTANT,PROGRESS_REPORT)
 		<< "Found d" << std::endl;
 
+	if (computePolyDetFFT(result,F,A,(size_t)d))
+		return result;
+
 	int a,e=1;
 	a=F.cardinality();
 	int newCard=a;
@@ -227,10 +227,49 @@ namespace LinBox
 			_R.monicIn(det);
 		}
 		
+		// Weak Popov reductions done on a contiguous copy of M over the coefficient field
 		template<class Matrix1>
 		void detPopov(Polynomial &det, const Matrix1 &M) const {
-			WeakPopovFormDomain<Ring> PFD(_R);
-			PFD.solveDet(det, M);
+			typedef typename Ring::CoeffField CoeffField;
+			typedef PolynomialMatrixWeakPopovDomain<CoeffField> PopovDom;
+			const CoeffField &F = _R.getCoeffField();
+			
+			size_t s = 1;
+			for (size_t i = 0; i < M.rowdim(); i++) {
+				for (size_t j = 0; j < M.coldim(); j++) {
+					s = std::max(s, _R.deg(M.getEntry(i, j)) + 1);
+				}
+			}
+			
+			typename PopovDom::MatrixP T(F, M.rowdim(), M.coldim(), s);
+			for (size_t i = 0; i < M.rowdim(); i++) {
+				for (size_t j = 0; j < M.coldim(); j++) {
+					const Polynomial &e = M.getEntry(i, j);
+					for (size_t k = 0; k <= _R.deg(e); k++) {
+						_R.getCoeff(T.ref(i, j, k), e, k);
+					}
+				}
+			}
+			
+			PopovDom PFD(F);
+			typename PopovDom::Polynomial d;
+			PFD.solveDetIn(d, T);
+			_R.init(det, d);
+			_R.monicIn(det);
+		}
+		
+		// Same, for a matrix already stored contiguously over any coefficient field
+		template<class Field>
+		void detPopov(Polynomial &det, const PolynomialMatrix<PMType::polfirst, PMStorage::plain, Field> &M) const {
+			PolynomialMatrixWeakPopovDomain<Field> PFD(M.field());
+			typename PolynomialMatrixWeakPopovDomain<Field>::Polynomial d;
+			PFD.solveDet(d, M);
+			
+			std::vector<integer> v(d.size());
+			for (size_t k = 0; k < d.size(); k++) {
+				M.field().convert(v[k], d[k]);
+			}
+			_R.init(det, v);
 			_R.monicIn(det);
 		}
 		
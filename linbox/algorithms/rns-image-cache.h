@@ -0,0 +1,321 @@
+/* Copyright (C) 2016 the members of the LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file algorithms/rns-image-cache.h
+ * @ingroup algorithms
+ * @ingroup CRA
+ * @brief Batched reduction of an integer matrix modulo many primes.
+ *
+ * A CRA iteration usually starts by building the image of an integer
+ * matrix modulo the current prime, which costs a full big-integer
+ * reduction of every entry per prime. MultiModImageCache reduces the
+ * matrix once for a whole batch of primes: entries are split in 16-bit
+ * chunks (Kronecker substitution) and multiplied by the table of the
+ * powers \f$2^{16j} \bmod p_i\f$ with a single floating point gemm, as
+ * FFPACK::rns_double does. Contrary to rns_double, there is no
+ * requirement that the product of the batch primes exceeds the entries.
+ *
+ * PrefetchPrimeIterator wraps any prime iterator, draws its primes by
+ * batches and hands each batch to a prefetcher (typically the CRA
+ * iteration owning the caches) before the primes are consumed.
+ */
+
+#ifndef __LINBOX_rns_image_cache_H
+#define __LINBOX_rns_image_cache_H
+
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <atomic>
+
+#include <givaro/modular.h>
+#include <fflas-ffpack/fflas/fflas.h>
+
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/matrix/dense-matrix.h"
+
+namespace LinBox
+{
+
+	/*! @brief Images of an integer matrix modulo a batch of word size primes.
+	 * @ingroup CRA
+	 *
+	 * The images are computed by reduce() (all primes of the batch at once)
+	 * and fetched by image(). The images of the previous batch are kept as
+	 * well, for primes drawn before a batch boundary but used after it.
+	 * Fetching does not modify the images, so several threads may fetch
+	 * concurrently as long as no reduce() is running, which is the case
+	 * for ChineseRemainderOMP where primes are drawn by the master thread
+	 * before each parallel round.
+	 *
+	 * @tparam IntMatrix dense matrix of Integer with \c getPointer() and \c getStride()
+	 */
+	template<class IntMatrix>
+	class MultiModImageCache {
+	public:
+		typedef Givaro::Modular<double>     Field;
+		typedef Field::Element            Element;
+		typedef BlasMatrix<Field>   ModularMatrix;
+
+	protected:
+		const IntMatrix                  &_A;
+		size_t                        _chunks; //!< number of 16-bit chunks of the largest entry
+		std::vector<double>            _split; //!< \c mn x \c _chunks Kronecker split of A
+		std::map<integer,std::vector<double> > _images;
+		std::map<integer,std::vector<double> > _previous; //!< images of the batch before
+		mutable std::atomic<size_t> _hits, _misses;
+
+	public:
+		/*! Constructor.
+		 * The matrix is split once and for all; \p A must outlive the cache.
+		 */
+		MultiModImageCache(const IntMatrix& A) :
+			_A(A), _chunks(0), _hits(0), _misses(0)
+		{
+			split();
+		}
+
+		const IntMatrix& matrix() const { return _A; }
+
+		/*! Number of primes currently cached, in the last two batches.
+		 */
+		size_t size() const { return _images.size() + _previous.size(); }
+
+		//! Number of images taken from the cache by image().
+		size_t hits() const { return _hits; }
+		//! Number of images computed entrywise by image().
+		size_t misses() const { return _misses; }
+
+		/*! Drops every cached image.
+		 */
+		void clear() { _images.clear(); _previous.clear(); }
+
+		/*! Reduces the matrix modulo all the primes of \p primes.
+		 * The images of the batch before are dropped, those of the last
+		 * batch are kept.
+		 * @param primes word size primes (each < 2^26), duplicates are ignored
+		 */
+		template<class PrimeVector>
+		void reduce(const PrimeVector& primes)
+		{
+			_previous.swap(_images);
+			_images.clear();
+
+			std::set<integer> uniq(primes.begin(), primes.end());
+			const size_t s  = uniq.size();
+			const size_t mn = _A.rowdim()*_A.coldim();
+			if (s == 0 || mn == 0) {
+				for (auto p : uniq)
+					_images[p].resize(mn);
+				return;
+			}
+
+			// The powers 2^{16j} mod p_i (s x chunks, row major)
+			std::vector<double> pw(s*_chunks);
+			std::vector<Field> fields; fields.reserve(s);
+			double pmax = 0;
+			{
+				size_t i = 0;
+				for (auto p : uniq) {
+					fields.emplace_back(p);
+					const Field& F = fields.back();
+					Element b, bj; F.init(b, (double)(1<<16)); F.assign(bj, F.one);
+					for (size_t j = 0; j < _chunks; ++j) {
+						pw[i*_chunks+j] = bj;
+						F.mulin(bj, b);
+					}
+					pmax = std::max(pmax, (double)p);
+					++i;
+				}
+			}
+
+			// Largest number of chunks such that p + K (p-1) (2^16-1) < 2^53
+			const double two53 = 9007199254740992.;
+			size_t K = (size_t)((two53 - pmax) / ((pmax-1) * 65535.));
+			K = std::max(std::min(K, _chunks), (size_t)1);
+
+			std::vector<double> R(s*mn, 0.);
+			Givaro::ZRing<double> D;
+			for (size_t kb = 0; kb < _chunks; kb += K) {
+				const size_t kk = std::min(K, _chunks-kb);
+				FFLAS::fgemm(D, FFLAS::FflasNoTrans, FFLAS::FflasTrans,
+					     s, mn, kk,
+					     D.one, pw.data()+kb, _chunks,
+					     _split.data()+kb, _chunks,
+					     D.one, R.data(), mn);
+				for (size_t i = 0; i < s; ++i)
+					FFLAS::freduce(fields[i], mn, R.data()+i*mn, 1);
+			}
+
+			size_t i = 0;
+			for (auto p : uniq) {
+				_images[p].assign(R.begin()+(ptrdiff_t)(i*mn), R.begin()+(ptrdiff_t)((i+1)*mn));
+				++i;
+			}
+		}
+
+		/*! Image of the matrix modulo the characteristic of \p F.
+		 * Falls back to a direct entrywise reduction when the prime is not cached.
+		 * @param[out] Ap resized to the dimensions of the matrix
+		 * @return \c true if the image was taken from the cache
+		 */
+		bool image(ModularMatrix& Ap, const Field& F) const
+		{
+			const size_t m = _A.rowdim(), n = _A.coldim();
+			Ap.resize(m, n);
+			integer p; F.characteristic(p);
+			auto it = _images.find(p);
+			bool found = it != _images.end();
+			if (!found) {
+				it = _previous.find(p);
+				found = it != _previous.end();
+			}
+			if (!found) {
+				for (size_t i = 0; i < m; ++i)
+					for (size_t j = 0; j < n; ++j)
+						F.init(Ap.refEntry(i,j), _A.getEntry(i,j));
+				++_misses;
+				return false;
+			}
+			++_hits;
+			for (size_t i = 0; i < m; ++i)
+				std::copy(it->second.begin()+(ptrdiff_t)(i*n), it->second.begin()+(ptrdiff_t)((i+1)*n),
+					  Ap.getPointer()+i*Ap.getStride());
+			return true;
+		}
+
+	protected:
+		//! Kronecker split of the (signed) entries in base 2^16.
+		void split()
+		{
+			const size_t m = _A.rowdim(), n = _A.coldim();
+			const size_t lda = _A.getStride();
+			auto Ap = _A.getPointer();
+
+			size_t maxbits = 0;
+			for (size_t i = 0; i < m; ++i)
+				for (size_t j = 0; j < n; ++j)
+					maxbits = std::max(maxbits, (size_t)Ap[i*lda+j].bitsize());
+			_chunks = std::max((maxbits+15)/16, (size_t)1);
+
+			const size_t perlimb = sizeof(mp_limb_t)/sizeof(uint16_t);
+			_split.assign(m*n*_chunks, 0.);
+			for (size_t i = 0; i < m; ++i)
+				for (size_t j = 0; j < n; ++j) {
+					const integer& a = Ap[i*lda+j];
+					const __mpz_struct* z = a.get_mpz();
+					const double sgn = (mpz_sgn(z) < 0) ? -1. : 1.;
+					double* out = _split.data()+(i*n+j)*_chunks;
+					const size_t nl = mpz_size(z);
+					for (size_t l = 0; l < nl; ++l) {
+						mp_limb_t limb = mpz_getlimbn(z, (mp_size_t)l);
+						for (size_t c = 0; c < perlimb && l*perlimb+c < _chunks; ++c) {
+							out[l*perlimb+c] = sgn * (double)(limb & 0xFFFF);
+							limb >>= 16;
+						}
+					}
+				}
+		}
+	};
+
+	/*! @brief Prime iterator drawing its primes by batches.
+	 * @ingroup primes
+	 *
+	 * Each time a new batch of \c size() primes is drawn from the underlying
+	 * iterator, <code>prefetcher.prefetch(batch)</code> is called, so that
+	 * per-prime precomputations (see MultiModImageCache) can be amortised
+	 * over the batch. The sequence of primes seen through this iterator is
+	 * exactly the sequence produced by the underlying one.
+	 *
+	 * CRA loops advance the iterator right after taking a prime and before
+	 * using it, so a new batch is only drawn when a prime past the end of
+	 * the current one is looked at, not when the iterator is advanced.
+	 *
+	 * @tparam PrimeIter  any prime iterator (e.g. PrimeIterator)
+	 * @tparam Prefetcher any type with a \c prefetch(const std::vector<integer>&) method
+	 */
+	template<class PrimeIter, class Prefetcher>
+	class PrefetchPrimeIterator {
+	public:
+		typedef typename PrimeIter::Prime_Type          Prime_Type;
+		typedef typename PrimeIter::UniqueSamplingTag   UniqueSamplingTag;
+		typedef typename PrimeIter::IteratorTag         IteratorTag;
+
+	protected:
+		PrimeIter                 &_gen;
+		Prefetcher             &_fetcher;
+		mutable std::vector<Prime_Type>  _batch;
+		mutable size_t                     _pos;
+
+		void refill() const
+		{
+			for (auto& p : _batch) {
+				p = *_gen;
+				++_gen;
+			}
+			_pos = 0;
+			_fetcher.prefetch(_batch);
+		}
+
+	public:
+		/*! Constructor.
+		 * @param gen underlying prime iterator (advanced by batches)
+		 * @param fetcher object notified of every new batch
+		 * @param batch number of primes drawn at once. With ChineseRemainderOMP,
+		 * it should be at least the number of threads.
+		 */
+		PrefetchPrimeIterator(PrimeIter& gen, Prefetcher& fetcher, size_t batch = 16) :
+			_gen(gen), _fetcher(fetcher), _batch(std::max(batch,(size_t)1)), _pos(_batch.size())
+		{}
+
+		PrefetchPrimeIterator& operator++ ()
+		{
+			if (_pos == _batch.size())
+				refill();
+			++_pos;
+			return *this;
+		}
+
+		const Prime_Type& operator* () const
+		{
+			if (_pos == _batch.size())
+				refill();
+			return _batch[_pos];
+		}
+
+		size_t size() const { return _batch.size(); }
+
+		uint64_t getBits() const { return _gen.getBits(); }
+	};
+
+}
+
+#endif // __LINBOX_rns_image_cache_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
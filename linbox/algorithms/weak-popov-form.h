@@ -32,6 +32,13 @@
 
 #include "linbox/matrix/densematrix/blas-matrix.h"
 #include "linbox/matrix/matrixdomain/matrix-domain.h"
+#include "linbox/matrix/polynomial-matrix.h"
+#include "linbox/algorithms/polynomial-matrix/polynomial-matrix-domain.h"
+
+#ifndef LINBOX_WEAK_POPOV_FFT_THRESHOLD
+// smallest degree of both factors for which the determinant factors are multiplied by FFT
+#define LINBOX_WEAK_POPOV_FFT_THRESHOLD 64
+#endif
 
 #ifndef __LINBOX_weak_popov_form_domain_H
 #define __LINBOX_weak_popov_form_domain_H
@@ -283,6 +290,257 @@ namespace LinBox
 			solveDetHelper(det, T);
 		}
 	}; // end of class WeakPopovFormDomain
+
+	/**
+	 * Determinant by weak Popov reductions over the contiguous polynomial
+	 * matrix representation, Field being the coefficient field.
+	 *
+	 * Same reduction as WeakPopovFormDomain::solveDet, but the entries
+	 * are stored in one PolynomialMatrix<polfirst> with coefficients of an
+	 * entry, and entries of a row, contiguous. Row operations are done in
+	 * place, the degrees and pivots of the entries are updated only for
+	 * the reduced row, and pivot collisions are found through a column to
+	 * row table instead of rescanning the matrix. The last column, whose
+	 * degrees may grow, lives in a scratch arena kept by the domain and
+	 * reused between levels and calls. The factors of the determinant are
+	 * multiplied by a product tree, using FFT when degrees are large.
+	 */
+	template<class Field>
+	class PolynomialMatrixWeakPopovDomain
+	{
+	public:
+		typedef typename Field::Element Element;
+		typedef PolynomialMatrix<PMType::polfirst,PMStorage::plain,Field> MatrixP;
+		typedef std::vector<Element> Polynomial; // coefficients by increasing degree
+
+	private:
+		const Field        *_field;
+		// scratch arena, reused between calls
+		std::vector<long>     _deg;   // degree of the entries of the current matrix, -1 for zero
+		std::vector<long>     _owner; // row owning the pivot of each column
+		std::vector<size_t>   _queue;
+		std::vector<Element>  _V;     // last column, _vcap coefficients per row
+		std::vector<long>     _vdeg;
+		size_t                _vcap;
+
+	public:
+		PolynomialMatrixWeakPopovDomain(const Field &F) : _field(&F), _vcap(0) {}
+
+		const Field& field() const { return *_field; }
+
+		/// det = determinant of T, T is left unchanged.
+		void solveDet(Polynomial &det, const MatrixP &T) {
+			MatrixP A(field(), T.rowdim(), T.coldim(), T.size());
+			A.copy(T, 0, T.size()-1);
+			solveDetIn(det, A);
+		}
+
+		/// det = determinant of T, T is destroyed.
+		void solveDetIn(Polynomial &det, MatrixP &T) {
+			const Field &F = field();
+			const size_t n = T.rowdim();
+			linbox_check(T.coldim() == n);
+
+			det.assign(1, F.one);
+			if (n == 0) return;
+
+			_deg.resize(n*n);
+			for (size_t i = 0; i < n*n; i++)
+				_deg[i] = _degree(&T.ref(i,0), (long)T.size()-1);
+
+			std::vector<Polynomial> factors;
+			factors.reserve(n);
+			bool odd = false;
+
+			for (size_t r = n; r > 1; r--) {
+				_loadLastColumn(T, r);
+				_reduce(T, r);
+
+				long k = -1;
+				for (size_t i = 0; i < r && k < 0; i++)
+					if (_pivot(T, i, r-1) < 0) k = (long)i;
+				linbox_check(k >= 0);
+
+				if (_vdeg[(size_t)k] < 0) {
+					det.assign(1, F.zero);
+					return;
+				}
+				const Element *v = &_V[(size_t)k*_vcap];
+				factors.push_back(Polynomial(v, v + _vdeg[(size_t)k] + 1));
+
+				if ((size_t)k != r-1) {
+					_swapRows(T, (size_t)k, r-1);
+					odd = !odd;
+				}
+			}
+
+			if (_deg[0] < 0) {
+				det.assign(1, F.zero);
+				return;
+			}
+			const Element *t = &T.ref(0,0);
+			factors.push_back(Polynomial(t, t + _deg[0] + 1));
+
+			_product(det, factors, 0, factors.size());
+			if (odd)
+				for (size_t i = 0; i < det.size(); i++)
+					F.negin(det[i]);
+		}
+
+	private:
+		long _degree(const Element *a, long d) const {
+			while (d >= 0 && field().isZero(a[d])) d--;
+			return d;
+		}
+
+		// right-most entry of maximal degree among the first c entries of row i
+		long _pivot(const MatrixP &T, size_t i, size_t c) const {
+			const long *deg = &_deg[i*T.coldim()];
+			long index = -1, max_deg = -1;
+			for (size_t j = 0; j < c; j++)
+				if (deg[j] >= 0 && deg[j] >= max_deg) {
+					index = (long)j;
+					max_deg = deg[j];
+				}
+			return index;
+		}
+
+		void _swapRows(MatrixP &T, size_t r1, size_t r2) {
+			const size_t n = T.coldim(), st = T.storage();
+			Element *a = &T.ref(r1*n,0), *b = &T.ref(r2*n,0);
+			std::swap_ranges(a, a + n*st, b);
+			std::swap_ranges(_deg.begin()+(long)(r1*n), _deg.begin()+(long)(r1*n+n), _deg.begin()+(long)(r2*n));
+		}
+
+		// copies column r-1 of the leading r x r block into the arena
+		void _loadLastColumn(MatrixP &T, size_t r) {
+			const size_t n = T.coldim();
+			if (_vcap < T.size() || _V.size() < r*_vcap) {
+				_vcap = std::max(_vcap, T.size());
+				_V.resize(n*_vcap);
+			}
+			_vdeg.resize(n);
+			for (size_t i = 0; i < r; i++) {
+				const Element *a = &T.ref(i*n+r-1,0);
+				long d = _deg[i*n+r-1];
+				std::copy(a, a + d + 1, &_V[i*_vcap]);
+				std::fill(&_V[i*_vcap] + d + 1, &_V[i*_vcap] + _vcap, field().zero);
+				_vdeg[i] = d;
+			}
+		}
+
+		// grows the arena so that a row holds cap coefficients
+		void _growLastColumn(size_t r, size_t cap) {
+			size_t ncap = std::max(cap, 2*_vcap);
+			std::vector<Element> V(_vdeg.size()*ncap, field().zero);
+			for (size_t i = 0; i < r; i++)
+				std::copy(&_V[i*_vcap], &_V[i*_vcap] + _vdeg[i] + 1, &V[i*ncap]);
+			_V.swap(V);
+			_vcap = ncap;
+		}
+
+		// row i += c x^e row o, on the first r-1 entries and on the arena
+		void _axpyRow(MatrixP &T, size_t r, size_t i, size_t o, const Element &c, size_t e) {
+			const Field &F = field();
+			const size_t n = T.coldim();
+			for (size_t j = 0; j+1 < r; j++) {
+				long d1 = _deg[o*n+j];
+				if (d1 < 0) continue;
+				const Element *a1 = &T.ref(o*n+j,0);
+				Element *a2 = &T.ref(i*n+j,0) + e;
+				for (long k = 0; k <= d1; k++)
+					F.axpyin(a2[k], c, a1[k]);
+				long &d2 = _deg[i*n+j];
+				d2 = _degree(a2 - e, std::max(d2, d1 + (long)e));
+			}
+
+			long d1 = _vdeg[o];
+			if (d1 < 0) return;
+			if ((size_t)d1 + e + 1 > _vcap)
+				_growLastColumn(r, (size_t)d1 + e + 1);
+			const Element *v1 = &_V[o*_vcap];
+			Element *v2 = &_V[i*_vcap] + e;
+			for (long k = 0; k <= d1; k++)
+				F.axpyin(v2[k], c, v1[k]);
+			_vdeg[i] = _degree(v2 - e, std::max(_vdeg[i], d1 + (long)e));
+		}
+
+		// weak Popov form of the first r-1 columns of the leading r x r block
+		void _reduce(MatrixP &T, size_t r) {
+			const Field &F = field();
+			const size_t n = T.coldim();
+			_owner.assign(r, -1);
+			_queue.clear();
+			for (size_t i = r; i > 0; i--)
+				_queue.push_back(i-1);
+
+			while (!_queue.empty()) {
+				size_t i = _queue.back();
+				_queue.pop_back();
+
+				long p = _pivot(T, i, r-1);
+				if (p < 0) continue;
+				if (_owner[(size_t)p] < 0) {
+					_owner[(size_t)p] = (long)i;
+					continue;
+				}
+
+				size_t o = (size_t)_owner[(size_t)p];
+				long di = _deg[i*n+(size_t)p], dO = _deg[o*n+(size_t)p];
+				if (di < dO) {
+					_owner[(size_t)p] = (long)i;
+					std::swap(i, o);
+					std::swap(di, dO);
+				}
+				// reduce row i by row o, which keeps the pivot
+				Element c;
+				F.div(c, T.ref(i*n+(size_t)p,(size_t)di), T.ref(o*n+(size_t)p,(size_t)dO));
+				F.negin(c);
+				_axpyRow(T, r, i, o, c, (size_t)(di - dO));
+				_queue.push_back(i);
+			}
+		}
+
+		// res = prod factors[b..e-1]
+		void _product(Polynomial &res, const std::vector<Polynomial> &factors, size_t b, size_t e) const {
+			if (e - b == 1) {
+				res = factors[b];
+				return;
+			}
+			Polynomial u, v;
+			_product(u, factors, b, (b+e)/2);
+			_product(v, factors, (b+e)/2, e);
+			_mul(res, u, v);
+		}
+
+		void _mul(Polynomial &c, const Polynomial &a, const Polynomial &b) const {
+			const Field &F = field();
+			if (std::min(a.size(), b.size()) >= LINBOX_WEAK_POPOV_FFT_THRESHOLD && _fftMul(c, a, b, F))
+				return;
+			c.assign(a.size()+b.size()-1, F.zero);
+			for (size_t i = 0; i < a.size(); i++)
+				for (size_t j = 0; j < b.size(); j++)
+					F.axpyin(c[i+j], a[i], b[j]);
+		}
+
+		template<class Field1>
+		bool _fftMul(Polynomial &, const Polynomial &, const Polynomial &, const Field1 &) const {
+			return false;
+		}
+
+		template<class T1, class T2>
+		bool _fftMul(Polynomial &c, const Polynomial &a, const Polynomial &b, const Givaro::Modular<T1,T2> &F) const {
+			MatrixP A(F, 1, 1, a.size()), B(F, 1, 1, b.size()), C(F, 1, 1, a.size()+b.size()-1);
+			std::copy(a.begin(), a.end(), &A.ref(0,0));
+			std::copy(b.begin(), b.end(), &B.ref(0,0));
+			PolynomialMatrixFFTMulDomain<Givaro::Modular<T1,T2> > PMD(F);
+			PMD.mul(C, A, B);
+			c.resize(a.size()+b.size()-1);
+			for (size_t k = 0; k < c.size(); k++)
+				c[k] = C.get(0,k);
+			return true;
+		}
+	}; // end of class PolynomialMatrixWeakPopovDomain
 }
 
 #endif // __LINBOX_weak_popov_form_domain_H
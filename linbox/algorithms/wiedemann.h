@@ -79,6 +79,7 @@
 
 // massey recurring sequence solver
 #include "linbox/algorithms/massey-domain.h"
+#include "linbox/algorithms/multi-massey-domain.h"
 
 namespace LinBox
 {
@@ -112,6 +113,11 @@ namespace LinBox
 
 			WD.minpoly (P, deg);
 		}
+		else if (M.nbProjections > 1) {
+			MultiMasseyDomain<Field, Blackbox> WD (&A, A.field(), M.nbProjections, M.earlyTerminationThreshold);
+
+			WD.minpoly (P, deg, i);
+		}
 		else {
 			typedef BlackboxContainer<Field, Blackbox> BBContainer;
 			BBContainer TF (&A, A.field(), i);
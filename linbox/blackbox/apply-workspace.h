@@ -0,0 +1,235 @@
+/* linbox/blackbox/apply-workspace.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/apply-workspace.h
+ * @ingroup blackbox
+ * @brief Intermediate vectors of the applies of composite blackboxes.
+ *
+ * Compose, Sum, Dif and Submatrix need intermediate vectors in their
+ * applies. They take them from an ApplyWorkspace, kept by each thread
+ * from one apply to the next, so that an apply neither allocates nor
+ * prevents several threads from applying the same blackbox. Sequence
+ * containers, which apply the same blackbox many times, may also give
+ * their own workspace to the blackboxes taking one (see
+ * has_apply_workspace).
+ */
+
+#ifndef __LINBOX_apply_workspace_H
+#define __LINBOX_apply_workspace_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "linbox/vector/blas-vector.h"
+
+#ifndef LINBOX_APPLY_WORKSPACE_KEEP
+// largest vector, in elements, a thread keeps from one apply to the next
+#define LINBOX_APPLY_WORKSPACE_KEEP (1 << 20)
+#endif
+
+namespace LinBox
+{
+
+	/** \brief Vectors of the calling thread for one apply of a blackbox of type \p Owner.
+	 * \ingroup blackbox
+	 *
+	 * An apply declares an ApplyWorkspace and takes its vectors from it.
+	 * The vectors are kept by the thread for the next apply of a blackbox
+	 * of type \p Owner, unless they are larger than
+	 * LINBOX_APPLY_WORKSPACE_KEEP. An apply nested in another one of the
+	 * same type, as in a composition of compositions, gets vectors of its
+	 * own.
+	 */
+	template <class Owner>
+	class ApplyWorkspace {
+	public:
+		ApplyWorkspace () : _level(_depth()++) {}
+
+		~ApplyWorkspace ()
+		{
+			for (auto release : _releasers())
+				release(_level);
+			--_depth();
+		}
+
+		ApplyWorkspace (const ApplyWorkspace&) = delete;
+		ApplyWorkspace& operator= (const ApplyWorkspace&) = delete;
+
+		/// The \p i-th vector of elements, of size \p n.
+		template <class Element>
+		std::vector<Element>& elements (size_t i, size_t n)
+		{
+			std::vector<Element>& v = _slot(_elements<Element>(), i);
+			v.resize(n);
+			return v;
+		}
+
+		/// The \p i-th vector over \p F, of size \p n.
+		template <class Field>
+		BlasVector<Field>& vector (const Field& F, size_t i, size_t n)
+		{
+			std::unique_ptr<BlasVector<Field> >& v = _slot(_vectors<Field>(), i);
+			if (! v || &(v->field()) != &F)
+				v.reset(new BlasVector<Field>(F, n));
+			else
+				v->resize(n);
+			return *v;
+		}
+
+	protected:
+		size_t _level; //!< number of applies of this type the thread was in
+
+		// vectors of each level; a deque keeps them in place when it grows
+		template <class T>
+		using Store = std::deque<std::deque<T> >;
+
+		typedef void (*Releaser) (size_t);
+
+		static size_t& _depth ()
+		{
+			static thread_local size_t depth = 0;
+			return depth;
+		}
+
+		// one per type of vector used by the thread
+		static std::vector<Releaser>& _releasers ()
+		{
+			static thread_local std::vector<Releaser> releasers;
+			return releasers;
+		}
+
+		template <class T>
+		T& _slot (Store<T>& store, size_t i) const
+		{
+			if (store.size() <= _level) store.resize(_level + 1);
+			if (store[_level].size() <= i) store[_level].resize(i + 1);
+			return store[_level][i];
+		}
+
+		template <class Element>
+		static Store<std::vector<Element> >& _elements ()
+		{
+			static thread_local Store<std::vector<Element> > store;
+			static thread_local bool registered = false;
+			if (! registered) {
+				_releasers().push_back(&_releaseElements<Element>);
+				registered = true;
+			}
+			return store;
+		}
+
+		template <class Field>
+		static Store<std::unique_ptr<BlasVector<Field> > >& _vectors ()
+		{
+			static thread_local Store<std::unique_ptr<BlasVector<Field> > > store;
+			static thread_local bool registered = false;
+			if (! registered) {
+				_releasers().push_back(&_releaseVectors<Field>);
+				registered = true;
+			}
+			return store;
+		}
+
+		template <class Element>
+		static void _releaseElements (size_t level)
+		{
+			Store<std::vector<Element> >& store = _elements<Element>();
+			if (level < store.size())
+				for (auto& v : store[level])
+					if (_footprint(v) > LINBOX_APPLY_WORKSPACE_KEEP)
+						std::vector<Element>().swap(v);
+		}
+
+		template <class T>
+		static size_t _footprint (const std::vector<T>& v)
+		{
+			return v.capacity();
+		}
+
+		template <class T>
+		static size_t _footprint (const std::vector<std::vector<T> >& v)
+		{
+			size_t f = v.capacity();
+			for (auto& w : v)
+				f += w.capacity();
+			return f;
+		}
+
+		template <class Field>
+		static void _releaseVectors (size_t level)
+		{
+			Store<std::unique_ptr<BlasVector<Field> > >& store = _vectors<Field>();
+			if (level < store.size())
+				for (auto& v : store[level])
+					if (v && v->size() > LINBOX_APPLY_WORKSPACE_KEEP)
+						v.reset();
+		}
+	};
+
+	/// Whether \c apply and \c applyTranspose take a workspace vector as third argument.
+	template <class Blackbox>
+	struct has_apply_workspace {
+		static const bool value = false;
+	};
+
+	/// y = A x, with the workspace \p z when \p A takes one.
+	template <class Blackbox, class OutVector, class InVector, class Workspace>
+	inline typename std::enable_if<has_apply_workspace<Blackbox>::value, OutVector&>::type
+	blackboxApply (OutVector& y, const Blackbox& A, const InVector& x, Workspace& z)
+	{
+		return A.apply(y, x, z);
+	}
+
+	template <class Blackbox, class OutVector, class InVector, class Workspace>
+	inline typename std::enable_if<!has_apply_workspace<Blackbox>::value, OutVector&>::type
+	blackboxApply (OutVector& y, const Blackbox& A, const InVector& x, Workspace&)
+	{
+		return A.apply(y, x);
+	}
+
+	/// y = A^T x, with the workspace \p z when \p A takes one.
+	template <class Blackbox, class OutVector, class InVector, class Workspace>
+	inline typename std::enable_if<has_apply_workspace<Blackbox>::value, OutVector&>::type
+	blackboxApplyTranspose (OutVector& y, const Blackbox& A, const InVector& x, Workspace& z)
+	{
+		return A.applyTranspose(y, x, z);
+	}
+
+	template <class Blackbox, class OutVector, class InVector, class Workspace>
+	inline typename std::enable_if<!has_apply_workspace<Blackbox>::value, OutVector&>::type
+	blackboxApplyTranspose (OutVector& y, const Blackbox& A, const InVector& x, Workspace&)
+	{
+		return A.applyTranspose(y, x);
+	}
+
+}
+
+#endif // __LINBOX_apply_workspace_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -43,6 +43,7 @@
 #include "linbox/randiter/multimod-randomprime.h"
 #include "linbox/matrix/sparse-matrix.h"
 #include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/matrix-stats.h"
 #include "linbox/algorithms/lifting-container.h"
 #include <vector>
 #include "linbox/vector/blas-vector.h"
@@ -358,20 +359,12 @@ namespace LinBox
 #else
 			// compute the magnitude in bit of the matrix
 			// check if at least one entry in the matrix is negative
-			LinBox::integer tmp=0, maxValue=0;
+			// (scanned at the first setup only, then kept by the domain)
+			if (! _stats)
+				_stats = std::make_shared<const MatrixStats>(MatrixStats::analyse(_matM));
+			LinBox::integer maxValue = _stats->maxNorm;
 			size_t maxBitSize = 0;
-			use_neg = false;
-			typename Matrix::ConstIterator it = _matM.Begin();
-			for (size_t i=0; i<_m*_n; i++, ++it) {
-				_domain.convert(tmp, *it);
-				if (tmp <0) {
-					use_neg = 1;
-					tmp=-tmp;
-				}
-				if (tmp> maxValue){
-					maxValue= tmp;
-				}
-			}
+			use_neg = _stats->negative;
 			size_t bit, dbit;
 			bit=maxValue.bitsize();
 			dbit= maxValue.size_in_base(4)*2;
@@ -839,7 +832,8 @@ namespace LinBox
 					integer res;
 					for (size_t j=0;j<_m;++j){
 						for (size_t i=0;i<rns_size;++i)
-							_rns->getBase(i).init(tmp[i], ctd[j+i*_m]);
+							tmp[i] = ctd[j+i*_m];
+						_rns->reduce(tmp.data());
 						_rns->convert(res, tmp);
 						_domain.init(y[j], res);
 						//if (y[j] > hmod) y[j]-=mod;
@@ -1036,6 +1030,7 @@ namespace LinBox
 		integer             shift;
 		ApplyChoice     _switcher;
 		MultiModDouble      *_rns;
+		MatrixStatsCache::Pointer _stats;
 		Element            _prime, _q, _inv_q, _pq, _h_pq;
 		mutable Timer              _apply, _convert_data, _convert_result;
 
@@ -1477,11 +1472,13 @@ namespace LinBox
 		typename IMatrix::ConstIterator it = Mat.Begin();
 		size_t mn = Mat.rowdim()*Mat.coldim();
 		integer tmp;
+		MultiModDouble::Element r(rns_size);
 
 		for (size_t i=0; i< mn; ++i, ++it){
 			D.convert(tmp,*it);
+			F.init(r, tmp);
 			for (size_t j=0;j< rns_size; ++j)
-				F.getBase(j).init(chunks[i+j*mn], tmp);
+				chunks[i+j*mn] = r[j];
 		}
 	}
 
@@ -1497,11 +1494,13 @@ namespace LinBox
 		typename IVector::const_iterator it= V.begin();
 		size_t mn = V.size();
 		integer tmp;
+		MultiModDouble::Element r(rns_size);
 
 		for (size_t i=0; i< mn; ++i, ++it){
 			D.convert(tmp, *it);
+			F.init(r, tmp);
 			for (size_t j=0;j< rns_size; ++j)
-				F.getBase(j).init(chunks[i+j*mn], tmp);
+				chunks[i+j*mn] = r[j];
 		}
 	}
 
@@ -27,6 +27,7 @@
 #define __LINBOX_blockbb_H
 
 #include <iostream>
+#include <type_traits>
 #include "linbox/util/error.h"
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/matrix/matrix-domain.h"
@@ -107,6 +108,52 @@ struct is_blockbb<BlockBB<_BB>> {
 	static const bool value = true;
 };
 
+/// dense matrices over a prime field apply blocks with one matrix product
+template<class T, class _Rep>
+struct is_blockbb<BlasMatrix<Givaro::Modular<T>, _Rep>> {
+	static const bool value = true;
+};
+
+/// Y = A*X, with the block apply of A when it has one, column by column otherwise.
+template<class BB, class Matrix>
+typename std::enable_if<is_blockbb<BB>::value, Matrix&>::type
+blockApplyLeft(Matrix& Y, const BB& A, const Matrix& X) {
+	return A.applyLeft(Y, X);
+}
+
+template<class BB, class Matrix>
+typename std::enable_if<!is_blockbb<BB>::value, Matrix&>::type
+blockApplyLeft(Matrix& Y, const BB& A, const Matrix& X) {
+	typename Matrix::ColIterator p1 = Y.colBegin();
+	typename Matrix::ConstColIterator p2 = X.colBegin();
+
+	for (; p2 != X.colEnd(); ++p1, ++p2) {
+		A.apply(*p1, *p2);
+	}
+
+	return Y;
+}
+
+/// Y = X*A, with the block apply of A when it has one, row by row otherwise.
+template<class BB, class Matrix>
+typename std::enable_if<is_blockbb<BB>::value, Matrix&>::type
+blockApplyRight(Matrix& Y, const BB& A, const Matrix& X) {
+	return A.applyRight(Y, X);
+}
+
+template<class BB, class Matrix>
+typename std::enable_if<!is_blockbb<BB>::value, Matrix&>::type
+blockApplyRight(Matrix& Y, const BB& A, const Matrix& X) {
+	typename Matrix::RowIterator p1 = Y.rowBegin();
+	typename Matrix::ConstRowIterator p2 = X.rowBegin();
+
+	for (; p2 != X.rowEnd(); ++p1, ++p2) {
+		A.applyTranspose(*p1, *p2);
+	}
+
+	return Y;
+}
+
 } // LinBox
 #endif // __LINBOX_blockbb_H
 
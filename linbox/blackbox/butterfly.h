@@ -46,7 +46,10 @@
 #ifndef __LINBOX_butterfly_H
 #define __LINBOX_butterfly_H
 
+#include <type_traits>
+
 #include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/blockbb.h"
 #include "linbox/vector/vector-domain.h"
 
 /*! @file blackbox/butterfly.h
@@ -70,6 +73,16 @@ namespace LinBox
 	/// Alternate butterfly switch object for testing.
 	class BooleanSwitch;
 
+	/** Whether a switch is determined by a single field coefficient.
+	 * The coefficients of such switches are stored contiguously, level
+	 * by level, and applied without going through the switch objects.
+	 */
+	template <class Switch>
+	struct ButterflyCoefficients : std::false_type {};
+
+	template <class Field>
+	struct ButterflyCoefficients<CekstvSwitch<Field> > : std::true_type {};
+
 	/** @name Butterfly
 	 * @brief Butterfly preconditioner and supporting function
 	 */
@@ -88,6 +101,12 @@ namespace LinBox
 	 * somehow be converted to dense vectors before this matrix may
 	 * be applied to them.
 	 *
+	 * The switches are grouped in levels of switches acting on disjoint
+	 * indices, stored as contiguous arrays of index pairs (and of
+	 * coefficients for CekstvSwitch), so that a whole level is applied
+	 * by one loop without dependencies, to a vector or to the rows
+	 * (columns) of a block.
+	 *
 	 * @param Vector LinBox dense vector type
 	 * @param Switch switch object type
 	 \ingroup blackbox
@@ -159,6 +178,16 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& applyTranspose (OutVector& y, const InVector& x) const;
 
+		/** Block application \f$ Y \gets P X \f$, level by level on the rows of \p X.
+		 */
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const;
+
+		/** Block application \f$ Y \gets X P \f$, level by level on the columns of \p X.
+		 */
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const;
+
 		template<typename _Tp1, typename _Sw1 = typename Switch::template rebind<_Tp1>::other>
 		struct rebind {
 			typedef Butterfly<_Tp1, _Sw1> other;
@@ -176,6 +205,7 @@ namespace LinBox
 					typename Switch::template rebind<_Tp1>() (newsw, *sit, Ap.field(), A.field());
 					Ap.switches().push_back( newsw );
 				}
+				Ap.buildLevels();
 				//             Ap = new other(LAp);
 			}
 		};
@@ -225,6 +255,13 @@ namespace LinBox
 		{ return this->_switches.end(); }
 		std::vector<Switch>& switches() { return _switches; }
 
+		/// Groups the switches in levels; to be called once switches() is filled.
+		void buildLevels ();
+
+		/// Number of levels of the network.
+		size_t levels () const
+		{ return _level.empty () ? 0 : _level.size () - 1; }
+
 
 	private:
 
@@ -248,11 +285,95 @@ namespace LinBox
 		// Vector of switches
 		std::vector<Switch> _switches;
 
+		// Level l is made of the switches _level[l] to _level[l+1]-1 of the
+		// arrays below, which never share an index.
+		std::vector<size_t> _level;
+		std::vector<size_t> _first, _second;
+
+		// Coefficients of the switches in level order when the switch
+		// has one (ButterflyCoefficients), the switches themselves otherwise.
+		std::vector<Element> _coeff;
+		std::vector<Switch> _lswitches;
+
+		typedef std::integral_constant<bool, ButterflyCoefficients<Switch>::value> HasCoeff;
+
 		// Build the vector of indices
 		void buildIndices ();
 
+		void storeSwitch (const Switch& s, std::true_type)
+		{ _coeff.push_back (s.getData ()); }
+		void storeSwitch (const Switch& s, std::false_type)
+		{ _lswitches.push_back (s); }
+
+		// Switch k of the level layout, or its transpose, on a pair of entries
+		template<class Ref1, class Ref2>
+		void switchApply (size_t k, Ref1&& x, Ref2&& y, std::true_type) const
+		{
+			field().axpyin (x, _coeff[k], y);
+			field().addin (y, x);
+		}
+		template<class Ref1, class Ref2>
+		void switchApply (size_t k, Ref1&& x, Ref2&& y, std::false_type) const
+		{ _lswitches[k].apply (field(), x, y); }
+
+		template<class Ref1, class Ref2>
+		void switchApplyTranspose (size_t k, Ref1&& x, Ref2&& y, std::true_type) const
+		{
+			field().addin (x, y);
+			field().axpyin (y, _coeff[k], x);
+		}
+		template<class Ref1, class Ref2>
+		void switchApplyTranspose (size_t k, Ref1&& x, Ref2&& y, std::false_type) const
+		{ _lswitches[k].applyTranspose (field(), x, y); }
+
+		// One level on a dense vector. The switches of a level are
+		// independent, so the coefficient loop is a gather/scatter
+		// multiply-add the compiler may vectorise.
+		template<class Vector>
+		void applyLevel (Vector& y, size_t b, size_t e, std::true_type) const
+		{
+			const Field& F = field();
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+			for (size_t k = b; k < e; ++k) {
+				F.axpyin (y[_first[k]], _coeff[k], y[_second[k]]);
+				F.addin (y[_second[k]], y[_first[k]]);
+			}
+		}
+		template<class Vector>
+		void applyLevel (Vector& y, size_t b, size_t e, std::false_type) const
+		{
+			for (size_t k = b; k < e; ++k)
+				_lswitches[k].apply (field(), y[_first[k]], y[_second[k]]);
+		}
+
+		template<class Vector>
+		void applyTransposeLevel (Vector& y, size_t b, size_t e, std::true_type) const
+		{
+			const Field& F = field();
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+			for (size_t k = b; k < e; ++k) {
+				F.addin (y[_first[k]], y[_second[k]]);
+				F.axpyin (y[_second[k]], _coeff[k], y[_first[k]]);
+			}
+		}
+		template<class Vector>
+		void applyTransposeLevel (Vector& y, size_t b, size_t e, std::false_type) const
+		{
+			for (size_t k = b; k < e; ++k)
+				_lswitches[k].applyTranspose (field(), y[_first[k]], y[_second[k]]);
+		}
+
 	}; // template <class Field, class Vector> class Butterfly
 
+	template <class Field, class Switch>
+	struct is_blockbb<Butterfly<Field, Switch> > {
+		static const bool value = true;
+	};
+
 	/** A function used with Butterfly Blackbox Matrices.
 	 * This function takes an STL vector x of booleans, and returns
 	 * a vector y of booleans such that setting the switches marked
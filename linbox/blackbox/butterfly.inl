@@ -48,6 +48,8 @@
 #define __LINBOX_butterfly_INL
 
 #include <vector>
+#include <algorithm>
+#include "linbox/util/debug.h"
 #include "linbox/blackbox/blackbox-interface.h"
 #include "linbox/vector/vector-domain.h"
 #include "linbox/field/hom.h"
@@ -70,19 +72,18 @@ namespace LinBox
 
 		for (unsigned int i = 0; i < _indices.size (); ++i)
 			_switches.push_back (factory.makeSwitch ());
+
+		buildLevels ();
 	}
 
 	template <class Field, class Switch>
 	template<class OutVector, class InVector>
 	inline OutVector& Butterfly<Field, Switch>::apply (OutVector& y, const InVector& x) const
 	{
-		std::vector< std::pair<size_t, size_t> >::const_iterator idx_iter = _indices.begin ();
-		typename std::vector<Switch>::const_iterator switch_iter = _switches.begin ();
-
 		_VD.copy (y, x);
 
-		for (; idx_iter != _indices.end (); ++idx_iter, ++switch_iter)
-			switch_iter->apply (field(), y[idx_iter->first], y[idx_iter->second]);
+		for (size_t l = 0; l < levels (); ++l)
+			applyLevel (y, _level[l], _level[l+1], HasCoeff());
 
 		return y;
 	}
@@ -91,17 +92,96 @@ namespace LinBox
 	template <class OutVector, class InVector>
 	inline OutVector& Butterfly<Field, Switch>::applyTranspose (OutVector& y, const InVector& x) const
 	{
-		std::vector< std::pair<size_t, size_t> >::const_reverse_iterator idx_iter = _indices.rbegin ();
-		typename std::vector<Switch>::const_reverse_iterator switch_iter = _switches.rbegin ();
-
 		_VD.copy (y, x);
 
-		for (; idx_iter != _indices.rend (); ++idx_iter, ++switch_iter)
-			switch_iter->applyTranspose (field(), y[idx_iter->first], y[idx_iter->second]);
+		for (size_t l = levels (); l-- > 0; )
+			applyTransposeLevel (y, _level[l], _level[l+1], HasCoeff());
 
 		return y;
 	}
 
+	template <class Field, class Switch>
+	template <class Matrix>
+	inline Matrix& Butterfly<Field, Switch>::applyLeft (Matrix& Y, const Matrix& X) const
+	{
+		linbox_check (Y.rowdim () == _n && X.rowdim () == _n);
+		linbox_check (Y.coldim () == X.coldim ());
+		const size_t w = X.coldim ();
+
+		for (size_t i = 0; i < _n; ++i)
+			for (size_t j = 0; j < w; ++j)
+				field().assign (Y.refEntry (i, j), X.getEntry (i, j));
+
+		// each switch combines two rows of the block
+		for (size_t l = 0; l < levels (); ++l)
+			for (size_t k = _level[l]; k < _level[l+1]; ++k) {
+				const size_t f = _first[k], s = _second[k];
+				for (size_t j = 0; j < w; ++j)
+					switchApply (k, Y.refEntry (f, j), Y.refEntry (s, j), HasCoeff());
+			}
+
+		return Y;
+	}
+
+	template <class Field, class Switch>
+	template <class Matrix>
+	inline Matrix& Butterfly<Field, Switch>::applyRight (Matrix& Y, const Matrix& X) const
+	{
+		linbox_check (Y.coldim () == _n && X.coldim () == _n);
+		linbox_check (Y.rowdim () == X.rowdim ());
+		const size_t h = X.rowdim ();
+
+		for (size_t i = 0; i < h; ++i)
+			for (size_t j = 0; j < _n; ++j)
+				field().assign (Y.refEntry (i, j), X.getEntry (i, j));
+
+		// rows of X P are the P^T images of the rows of X
+		for (size_t i = 0; i < h; ++i)
+			for (size_t l = levels (); l-- > 0; )
+				for (size_t k = _level[l]; k < _level[l+1]; ++k)
+					switchApplyTranspose (k, Y.refEntry (i, _first[k]), Y.refEntry (i, _second[k]), HasCoeff());
+
+		return Y;
+	}
+
+	template <class Field, class Switch>
+	void Butterfly<Field, Switch>::buildLevels ()
+	{
+		linbox_check (_switches.size () == _indices.size ());
+
+		// A switch goes one level after the last one touching either of its indices,
+		// which keeps the order of the operations on every entry.
+		std::vector<size_t> depth (_n, 0), lev (_indices.size ());
+		size_t nlevels = 0;
+		for (size_t k = 0; k < _indices.size (); ++k) {
+			size_t& d1 = depth[_indices[k].first];
+			size_t& d2 = depth[_indices[k].second];
+			lev[k] = std::max (d1, d2);
+			d1 = d2 = lev[k] + 1;
+			nlevels = std::max (nlevels, lev[k] + 1);
+		}
+
+		_level.assign (nlevels + 1, 0);
+		for (size_t k = 0; k < lev.size (); ++k)
+			++_level[lev[k]+1];
+		for (size_t l = 0; l < nlevels; ++l)
+			_level[l+1] += _level[l];
+
+		std::vector<size_t> order (lev.size ()), pos (_level.begin (), _level.end () - 1);
+		for (size_t k = 0; k < lev.size (); ++k)
+			order[pos[lev[k]]++] = k;
+
+		_first.resize (order.size ());
+		_second.resize (order.size ());
+		_coeff.clear ();
+		_lswitches.clear ();
+		for (size_t k = 0; k < order.size (); ++k) {
+			_first[k]  = _indices[order[k]].first;
+			_second[k] = _indices[order[k]].second;
+			storeSwitch (_switches[order[k]], HasCoeff());
+		}
+	}
+
 	template <class Field, class Switch>
 	void Butterfly<Field, Switch>::buildIndices ()
 	{
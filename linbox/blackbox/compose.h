@@ -32,6 +32,8 @@
 #include "linbox/linbox-config.h"
 #include "linbox/blackbox/blackbox-interface.h"
 #include "linbox/vector/blas-vector.h"
+#include "linbox/blackbox/blockbb.h"
+#include "linbox/blackbox/apply-workspace.h"
 
 namespace LinBox
 {
@@ -81,14 +83,8 @@ namespace LinBox
 		 * @param B blackbox
 		 */
 		Compose (const Blackbox1 &A, const Blackbox2 &B) :
-			_A_ptr(&A), _B_ptr(&B),_z(A.field())
-		{
-			// Rich Seagraves - "It seems VectorWrapper somehow
-			// became depricated.  Makes the assumption that
-			// this vector type supports resize"
-			// VectorWrapper::ensureDim (_z, _A_ptr->coldim ());
-			_z.resize(_A_ptr->coldim());
-		}
+			_A_ptr(&A), _B_ptr(&B)
+		{}
 
 		/** Constructor of C := (*A_ptr)*(*B_ptr).
 		 * This constructor creates a matrix that is a product of two black box
@@ -97,14 +93,11 @@ namespace LinBox
 		 * @param B_ptr blackbox
 		 */
 		Compose (const Blackbox1 *A_ptr, const Blackbox2 *B_ptr) :
-			_A_ptr(A_ptr), _B_ptr(B_ptr),_z(A_ptr->field())
+			_A_ptr(A_ptr), _B_ptr(B_ptr)
 		{
 			linbox_check (A_ptr != (Blackbox1 *) 0);
 			linbox_check (B_ptr != (Blackbox2 *) 0);
 			linbox_check (A_ptr->coldim () == B_ptr->rowdim ());
-
-			//			VectorWrapper::ensureDim (_z, _A_ptr->coldim ());
-			_z.resize(_A_ptr->coldim());
 		}
 
 		/** Copy constructor.
@@ -113,10 +106,8 @@ namespace LinBox
 		 * @param[in] Mat blackbox to copy.
 		 */
 		Compose (const Compose<Blackbox1, Blackbox2>& Mat) :
-			_A_ptr ( Mat._A_ptr), _B_ptr ( Mat._B_ptr),_z(Mat.field())
-		{
-			_z.resize(_A_ptr->coldim());
-		}
+			_A_ptr ( Mat._A_ptr), _B_ptr ( Mat._B_ptr)
+		{}
 
 		/// Destructor
 		~Compose () {}
@@ -135,16 +126,30 @@ namespace LinBox
 		/** Matrix * column vector product.
 		 * \f$ y \gets (A\cdot B)\cdot x\f$
 		 * Applies B, then A.
+		 * The intermediate vector comes from an ApplyWorkspace of the
+		 * calling thread, so that several threads may apply the same
+		 * composition, and a composition may be nested in another one.
 		 * @return reference to vector y containing output.
 		 * @param  x constant reference to vector to contain input
 		 * @param[out] y the result.
 		 */
 		template <class OutVector, class InVector>
 		inline OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			ApplyWorkspace<Self_t> ws;
+			return apply (y, x, ws.vector (field(), 0, _innerdim()));
+		}
+
+		/** Matrix * column vector product with a caller supplied workspace.
+		 * @param[in,out] z workspace, resized to <code>B.rowdim()</code>
+		 */
+		template <class OutVector, class InVector, class Workspace>
+		inline OutVector& apply (OutVector& y, const InVector& x, Workspace& z) const
 		{
 			if ((_A_ptr != 0) && (_B_ptr != 0)) {
-				_B_ptr->apply (_z, x);
-				_A_ptr->apply (y, _z);
+				if (z.size() != _innerdim()) z.resize(_innerdim());
+				_B_ptr->apply (z, x);
+				_A_ptr->apply (y, z);
 			}
 
 			return y;
@@ -159,15 +164,49 @@ namespace LinBox
 		 */
 		template <class OutVector, class InVector>
 		inline OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			ApplyWorkspace<Self_t> ws;
+			return applyTranspose (y, x, ws.vector (field(), 0, _innerdim()));
+		}
+
+		/** row vector * matrix product with a caller supplied workspace.
+		 * @param[in,out] z workspace, resized to <code>B.rowdim()</code>
+		 */
+		template <class OutVector, class InVector, class Workspace>
+		inline OutVector& applyTranspose (OutVector& y, const InVector& x, Workspace& z) const
 		{
 			if ((_A_ptr != 0) && (_B_ptr != 0)) {
-				_A_ptr->applyTranspose (_z, x);
-				_B_ptr->applyTranspose (y, _z);
+				if (z.size() != _innerdim()) z.resize(_innerdim());
+				_A_ptr->applyTranspose (z, x);
+				_B_ptr->applyTranspose (y, z);
 			}
 
 			return y;
 		}
 
+		/** Block product \f$ Y \gets (A\cdot B)\cdot X\f$.
+		 * The whole block goes through B, then through A: block
+		 * blackboxes (see is_blockbb) use their own block apply, the
+		 * others are applied column by column.
+		 */
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			Matrix Z(field(), _innerdim(), X.coldim());
+			blockApplyLeft (Z, *_B_ptr, X);
+			return blockApplyLeft (Y, *_A_ptr, Z);
+		}
+
+		/** Block product \f$ Y \gets X\cdot (A\cdot B)\f$.
+		 */
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			Matrix Z(field(), X.rowdim(), _innerdim());
+			blockApplyRight (Z, *_A_ptr, X);
+			return blockApplyRight (Y, *_B_ptr, Z);
+		}
+
 		template<typename _Tp1, typename _Tp2 = _Tp1>
 		struct rebind {
 			typedef ComposeOwner<
@@ -222,7 +261,6 @@ namespace LinBox
 		{
 			return  _A_ptr;
 		}
-
 		/// accessor to the blackboxes
 		const Blackbox2* getRightPtr() const
 		{
@@ -235,8 +273,11 @@ namespace LinBox
 		const Blackbox1 *_A_ptr;
 		const Blackbox2 *_B_ptr;
 
-		// local intermediate vector
-		mutable BlasVector<Field> _z;
+		// Size of the intermediate vectors
+		size_t _innerdim (void) const
+		{
+			return (_B_ptr != 0) ? _B_ptr->rowdim () : 0;
+		}
 	};
 
 	/// specialization for _Blackbox1 = _Blackbox2
@@ -289,21 +330,28 @@ namespace LinBox
 
 		~Compose () {}
 
+		/*! Application of BlackBox matrix.
+		 * The intermediate vectors come from an ApplyWorkspace of the
+		 * calling thread, so that several threads may apply the same
+		 * composition, and a composition may be nested in another one.
+		 */
 		template <class OutVector, class InVector>
 		inline OutVector& apply (OutVector& y, const InVector& x) const
 		{
+			ApplyWorkspace<Self_t> ws;
+			std::vector<std::vector<Element> >& zl = _workspace(ws);
 
 			typename std::vector<const Blackbox*>::const_reverse_iterator b_p;
 			typename std::vector<std::vector<Element> >::reverse_iterator z_p, pz_p;
 			b_p = _BlackboxL.rbegin();
-			pz_p = z_p = _zl.rbegin();
+			pz_p = z_p = zl.rbegin();
 			typedef BlasSubvector<BlasVector<Field, typename Vector<Field>::Dense> > BSub;
 			BSub pz_p_vec(field(),*pz_p);
 
 			(*b_p) -> apply(pz_p_vec, x);
 			++ b_p;  ++ z_p;
 
-			for (; z_p != _zl.rend(); ++ b_p, ++ z_p, ++ pz_p) {
+			for (; z_p != zl.rend(); ++ b_p, ++ z_p, ++ pz_p) {
 				 BSub z_p_vec(field(),*z_p);
 				(*b_p) -> apply (z_p_vec,pz_p_vec);
 			}
@@ -325,17 +373,20 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& applyTranspose (OutVector& y, const InVector& x) const
 		{
-			typename std::vector<const Blackbox*>::reverse_iterator b_p;
+			ApplyWorkspace<Self_t> ws;
+			std::vector<std::vector<Element> >& zl = _workspace(ws);
+
+			typename std::vector<const Blackbox*>::const_reverse_iterator b_p;
 			typename std::vector<std::vector<Element> >::reverse_iterator z_p, nz_p;
 
 			b_p = _BlackboxL.rbegin();
-			z_p = nz_p = _zl.rbegin();
+			z_p = nz_p = zl.rbegin();
 
 			(*b_p) -> applyTranspose (*z_p, x);
 
 			++ b_p; ++ nz_p;
 
-			for (; nz_p != _zl.rend(); ++ z_p, ++ nz_p, ++ b_p)
+			for (; nz_p != zl.rend(); ++ z_p, ++ nz_p, ++ b_p)
 				(*b_p) -> applyTranspose (*nz_p, *z_p);
 
 			(*b_p) -> applyTranspose (y, *z_p);
@@ -343,6 +394,36 @@ namespace LinBox
 			return y;
 		}
 
+		/** Block product: the whole block goes through every factor, last one first.
+		 */
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			Matrix Z(X);
+			typename std::vector<const Blackbox*>::const_reverse_iterator b_p = _BlackboxL.rbegin();
+			for (; b_p+1 != _BlackboxL.rend(); ++b_p) {
+				Matrix T(field(), (*b_p)->rowdim(), X.coldim());
+				blockApplyLeft (T, **b_p, Z);
+				Z = T;
+			}
+			return blockApplyLeft (Y, **b_p, Z);
+		}
+
+		/** Block product on the left: the whole block goes through every factor, first one first.
+		 */
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			Matrix Z(X);
+			typename std::vector<const Blackbox*>::const_iterator b_p = _BlackboxL.begin();
+			for (; b_p+1 != _BlackboxL.end(); ++b_p) {
+				Matrix T(field(), X.rowdim(), (*b_p)->coldim());
+				blockApplyRight (T, **b_p, Z);
+				Z = T;
+			}
+			return blockApplyRight (Y, **b_p, Z);
+		}
+
 		template<typename _Tp1>
 		struct rebind {
 			typedef Compose<typename Blackbox::template rebind<_Tp1>::other, typename Blackbox::template rebind<_Tp1>::other> other;
@@ -395,12 +476,38 @@ namespace LinBox
 		// Pointers to A and B matrices
 		std::vector<const Blackbox*> _BlackboxL;
 
-		// local intermediate vector
-		mutable std::vector<std::vector<Element> > _zl;
+		// shapes of the intermediate vectors
+		std::vector<std::vector<Element> > _zl;
+
+		// intermediate vectors of the calling thread, shaped as _zl
+		std::vector<std::vector<Element> >& _workspace (ApplyWorkspace<Self_t>& ws) const
+		{
+			std::vector<std::vector<Element> >& zl = ws.template elements<std::vector<Element> > (0, _zl.size());
+			for (size_t k = 0; k < _zl.size(); ++k)
+				zl[k].resize(_zl[k].size());
+			return zl;
+		}
 	};
 
 	//@}
 
+	/// A composition has a block apply worth using when one of its factors has one.
+	template <class _Blackbox1, class _Blackbox2>
+	struct is_blockbb<Compose<_Blackbox1, _Blackbox2> > {
+		static const bool value = is_blockbb<_Blackbox1>::value || is_blockbb<_Blackbox2>::value;
+	};
+
+	template <class _Blackbox1, class _Blackbox2>
+	struct has_apply_workspace<Compose<_Blackbox1, _Blackbox2> > {
+		static const bool value = true;
+	};
+
+	/// A composition of several factors keeps its own workspace.
+	template <class _Blackbox>
+	struct has_apply_workspace<Compose<_Blackbox, _Blackbox> > {
+		static const bool value = false;
+	};
+
 } // namespace LinBox
 
 // was compose-traits.h (by Zhendong Wan)
@@ -467,14 +574,7 @@ namespace LinBox
 		 */
 		ComposeOwner (const Blackbox1 &A, const Blackbox2 &B) :
 			_A_data(A), _B_data(B)
-			,_z(A.field())
-		{
-			// Rich Seagraves - "It seems VectorWrapper somehow
-			// became depricated.  Makes the assumption that
-			// this vector type supports resize"
-			// VectorWrapper::ensureDim (_z, _A_data.coldim ());
-			_z.resize(_A_data.coldim());
-		}
+		{}
 
 		/** Constructor of C := (*A_data)*(*B_data).
 		 * This constructor creates a matrix that is a product of two black box
@@ -482,14 +582,10 @@ namespace LinBox
 		 */
 		ComposeOwner (const Blackbox1 *A_data, const Blackbox2 *B_data) :
 			_A_data(*A_data), _B_data(*B_data)
-			,_z(A_data->field())
 		{
 			linbox_check (A_data != (Blackbox1 *) 0);
 			linbox_check (B_data != (Blackbox2 *) 0);
 			linbox_check (A_data->coldim () == B_data->rowdim ());
-
-			// VectorWrapper::ensureDim (_z, _A_data.coldim ());
-			_z.resize(_A_data.coldim());
 		}
 
 		/** Copy constructor.
@@ -499,10 +595,7 @@ namespace LinBox
 		 */
 		ComposeOwner (const ComposeOwner<Blackbox1, Blackbox2>& Mat) :
 			_A_data ( Mat.getLeftData()), _B_data ( Mat.getRightData())
-			,_z(Mat.field())
-		{
-			_z.resize(_A_data.coldim());
-		}
+		{}
 
 
 		/// Destructor
@@ -531,7 +624,16 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& apply (OutVector& y, const InVector& x) const
 		{
-			return _A_data.apply (y, _B_data.apply (_z, x));
+			ApplyWorkspace<Self_t> ws;
+			return apply (y, x, ws.vector (field(), 0, _B_data.rowdim()));
+		}
+
+		/// Same, with a caller supplied workspace \p z, resized to <code>B.rowdim()</code>.
+		template <class OutVector, class InVector, class Workspace>
+		inline OutVector& apply (OutVector& y, const InVector& x, Workspace& z) const
+		{
+			if (z.size() != _B_data.rowdim()) z.resize(_B_data.rowdim());
+			return _A_data.apply (y, _B_data.apply (z, x));
 		}
 
 		/** row vector * matrix product \f$y= (A \times B)^T \cdot x\f$.
@@ -543,7 +645,34 @@ namespace LinBox
 		template <class OutVector, class InVector>
 		inline OutVector& applyTranspose (OutVector& y, const InVector& x) const
 		{
-			return _B_data.applyTranspose (y, _A_data.applyTranspose (_z, x));
+			ApplyWorkspace<Self_t> ws;
+			return applyTranspose (y, x, ws.vector (field(), 0, _B_data.rowdim()));
+		}
+
+		/// Same, with a caller supplied workspace \p z, resized to <code>B.rowdim()</code>.
+		template <class OutVector, class InVector, class Workspace>
+		inline OutVector& applyTranspose (OutVector& y, const InVector& x, Workspace& z) const
+		{
+			if (z.size() != _B_data.rowdim()) z.resize(_B_data.rowdim());
+			return _B_data.applyTranspose (y, _A_data.applyTranspose (z, x));
+		}
+
+		/// Block product \f$ Y \gets (A\cdot B)\cdot X\f$.
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			Matrix Z(field(), _B_data.rowdim(), X.coldim());
+			blockApplyLeft (Z, _B_data, X);
+			return blockApplyLeft (Y, _A_data, Z);
+		}
+
+		/// Block product \f$ Y \gets X\cdot (A\cdot B)\f$.
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			Matrix Z(field(), X.rowdim(), _B_data.rowdim());
+			blockApplyRight (Z, _A_data, X);
+			return blockApplyRight (Y, _B_data, Z);
 		}
 
 		template<typename _Tp1, typename _Tp2 = _Tp1>
@@ -564,8 +693,7 @@ namespace LinBox
 		template<typename _BBt1, typename _BBt2, typename Field>
 		ComposeOwner (const Compose<_BBt1, _BBt2> &Mat, const Field& F) :
 			_A_data(*(Mat.getLeftPtr()), F),
-			_B_data(*(Mat.getRightPtr()), F),
-			_z(F,_A_data.coldim())
+			_B_data(*(Mat.getRightPtr()), F)
 		{
 			typename Compose<_BBt1, _BBt2>::template rebind<Field>()(*this,Mat);
 		}
@@ -573,8 +701,7 @@ namespace LinBox
 		template<typename _BBt1, typename _BBt2, typename Field>
 		ComposeOwner (const ComposeOwner<_BBt1, _BBt2> &Mat, const Field& F) :
 			_A_data(Mat.getLeftData(), F),
-			_B_data(Mat.getRightData(), F) ,
-			_z(F,_A_data.coldim())
+			_B_data(Mat.getRightData(), F)
 		{
 			typename ComposeOwner<_BBt1, _BBt2>::template rebind<Field>()(*this,Mat);
 		}
@@ -619,9 +746,16 @@ namespace LinBox
 		// A and B matrices
 		Blackbox1 _A_data;
 		Blackbox2 _B_data;
+	};
 
-		// local intermediate vector
-		mutable BlasVector<Field> _z;
+	template <class _Blackbox1, class _Blackbox2>
+	struct is_blockbb<ComposeOwner<_Blackbox1, _Blackbox2> > {
+		static const bool value = is_blockbb<_Blackbox1>::value || is_blockbb<_Blackbox2>::value;
+	};
+
+	template <class _Blackbox1, class _Blackbox2>
+	struct has_apply_workspace<ComposeOwner<_Blackbox1, _Blackbox2> > {
+		static const bool value = true;
 	};
 
 } // LinBox
@@ -0,0 +1,131 @@
+/* linbox/blackbox/dense-apply.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/dense-apply.h
+ * @ingroup blackbox
+ * @brief Dense matrix over a prime field, packed once for many applies.
+ *
+ * Wiedemann and block Wiedemann apply the same matrix hundreds of times.
+ * Wrapping a BlasMatrix in a DenseApplyBlackbox packs it once into a
+ * DenseApplyEngine, whose applies delay the reductions modulo \p p.
+ */
+
+#ifndef __LINBOX_dense_apply_H
+#define __LINBOX_dense_apply_H
+
+#include <memory>
+#include <type_traits>
+
+#include "linbox/linbox-config.h"
+#include "linbox/util/debug.h"
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/matrix/matrix-category.h"
+#include "linbox/matrix/matrixdomain/dense-apply-engine.h"
+#include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/blockbb.h"
+
+namespace LinBox
+{
+
+	/** \brief Blackbox of a BlasMatrix over \c Givaro::Modular, applied through a packed copy.
+	 * \ingroup blackbox
+	 *
+	 * The copy is made by the constructor: \p A must outlive the blackbox
+	 * and must not be modified while it is in use. When the matrix is too
+	 * small, or the prime too large for the delayed reductions, the
+	 * applies are those of \p A.
+	 */
+	template <class Matrix>
+	class DenseApplyBlackbox : public BlackboxInterface {
+	public:
+		typedef typename Matrix::Field           Field;
+		typedef typename Field::Element        Element;
+		typedef DenseApplyBlackbox<Matrix>      Self_t;
+		typedef MatrixCategories::BlackboxTag MatrixCategory;
+
+		static_assert(DenseApplyEngineTraits<Field>::value, "DenseApplyBlackbox needs a Givaro::Modular field");
+
+		/// Packs \p A, applies use \p threads threads (0 for all, see BlasParallelism).
+		DenseApplyBlackbox (const Matrix& A, size_t threads = 1) :
+			_A(&A)
+		{
+			if (A.rowdim() * A.coldim() >= LINBOX_DENSE_APPLY_THRESHOLD && DenseApplyEngine<Field>::suitable(A.field()))
+				_engine = std::make_shared<const DenseApplyEngine<Field> >(A.field(), A.getPointer(), A.rowdim(), A.coldim(),
+											  A.getStride(), threads);
+		}
+
+		//! y = A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			return _engine ? _engine->apply(y, x) : _A->apply(y, x);
+		}
+
+		//! y = A^T x
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			return _engine ? _engine->applyTranspose(y, x) : _A->applyTranspose(y, x);
+		}
+
+		//! Y = A X, for dense matrices with getPointer() and getStride()
+		template<class Matrix1, class Matrix2>
+		Matrix1& applyLeft (Matrix1& Y, const Matrix2& X) const
+		{
+			return _engine ? _engine->applyLeft(Y, X) : _A->applyLeft(Y, X);
+		}
+
+		//! Y = X A, for dense matrices with getPointer() and getStride()
+		template<class Matrix1, class Matrix2>
+		Matrix1& applyRight (Matrix1& Y, const Matrix2& X) const
+		{
+			return _engine ? _engine->applyRight(Y, X) : _A->applyRight(Y, X);
+		}
+
+		size_t rowdim () const { return _A->rowdim(); }
+		size_t coldim () const { return _A->coldim(); }
+		const Field& field () const { return _A->field(); }
+
+		//! Whether the applies go through a packed copy.
+		bool packed () const { return (bool)_engine; }
+
+	protected:
+		const Matrix                                        *_A;
+		std::shared_ptr<const DenseApplyEngine<Field> > _engine;
+	};
+
+	template<class Matrix>
+	struct is_blockbb<DenseApplyBlackbox<Matrix> > {
+		static const bool value = true;
+	};
+
+}
+
+#endif // __LINBOX_dense_apply_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -36,6 +36,7 @@
 #include "linbox/vector/vector-domain.h"
 #include "linbox/util/debug.h"
 #include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/apply-workspace.h"
 
 // Namespace in which all LinBox library code resides
 namespace LinBox
@@ -69,9 +70,6 @@ namespace LinBox
 			// create new copies of matrices in dynamic memory
 			linbox_check (A.coldim () == B.coldim ());
 			linbox_check (A.rowdim () == B.rowdim ());
-
-			VectorWrapper::ensureDim (_z1, _A_ptr->rowdim ());
-			VectorWrapper::ensureDim (_z2, _A_ptr->coldim ());
 		}
 
 		/** Build this as A - B from blackbox pointers A_ptr, B_ptr.
@@ -89,8 +87,6 @@ namespace LinBox
 
 			// 			_A_ptr = A_ptr->clone ();
 			// 			_B_ptr = B_ptr->clone ();
-			VectorWrapper::ensureDim (_z1, A_ptr->rowdim ());
-			VectorWrapper::ensureDim (_z2, A_ptr->coldim ());
 		}
 
 		/** Makes a deep copy.
@@ -100,8 +96,6 @@ namespace LinBox
 		Dif (const Dif<Blackbox1, Blackbox2> &M) :
 			_A_ptr (M._A_ptr), _B_ptr (M._B_ptr)
 		{
-			VectorWrapper::ensureDim (_z1, _A_ptr->rowdim ());
-			VectorWrapper::ensureDim (_z2, _A_ptr->coldim ());
 		}
 
 		/// Destructor
@@ -127,9 +121,11 @@ namespace LinBox
 				VectorDomain<Field> VD (_A_ptr->field());
 
 				_A_ptr->apply (y, x);
-				_B_ptr->apply (_z1, x);
+				ApplyWorkspace<Self_t> ws;
+				std::vector<Element>& z1 = ws.template elements<Element> (0, rowdim ());
+				_B_ptr->apply (z1, x);
 
-				VD.subin(y, _z1);
+				VD.subin(y, z1);
 			}
 
 
@@ -151,8 +147,10 @@ namespace LinBox
 			if ((_A_ptr != 0) && (_B_ptr != 0)) {
 				VectorDomain<Field> VD (_A_ptr->field());
 				_A_ptr->applyTranspose (y, x);
-				_B_ptr->applyTranspose (_z2, x);
-				VD.subin (y, _z2);
+				ApplyWorkspace<Self_t> ws;
+				std::vector<Element>& z2 = ws.template elements<Element> (0, coldim ());
+				_B_ptr->applyTranspose (z2, x);
+				VD.subin (y, z2);
 			}
 
 			return y;
@@ -198,9 +196,6 @@ namespace LinBox
 		const Blackbox1       *_A_ptr;
 		const Blackbox2       *_B_ptr;
 
-		mutable std::vector<Element>  _z1;
-		mutable std::vector<Element>  _z2;
-
 	};
 
 } // namespace LinBox
@@ -0,0 +1,481 @@
+/* linbox/blackbox/fft-toeplitz.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/fft-toeplitz.h
+ * @ingroup blackbox
+ * @brief Toeplitz, Hankel and block Toeplitz blackboxes applied by FFT, without NTL.
+ *
+ * The product by an \f$m\times n\f$ Toeplitz matrix is the middle of the
+ * product of its generator by the vector, computed here by a cyclic
+ * convolution of length \f$N \geq m+n-1\f$ with the Harvey FFT of
+ * polynomial-fft-transform.h. The transforms of the generator are computed
+ * once, at construction, so that an apply costs \f$O(N\log N)\f$.
+ *
+ * When the characteristic \f$p\f$ is an FFT prime (\f$p<2^{29}\f$ and
+ * \f$N \mid p-1\f$) the convolution is done modulo \f$p\f$, otherwise
+ * modulo a few FFT primes and reconstructed modulo \f$p\f$ by Garner's
+ * algorithm. Meant for \c Givaro::Modular<uint32_t> and
+ * \c Givaro::Modular<double>; the characteristic must fit in 32 bits.
+ */
+
+#ifndef __LINBOX_fft_toeplitz_H
+#define __LINBOX_fft_toeplitz_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+#include <givaro/modular.h>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/field/hom.h"
+#include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/blockbb.h"
+#include "linbox/matrix/dense-matrix.h"
+#include "linbox/randiter/random-fftprime.h"
+#include "linbox/algorithms/polynomial-matrix/polynomial-fft-transform.h"
+
+namespace LinBox
+{
+
+	/** \brief Block Toeplitz blackbox applied by FFT.
+	 * \ingroup blackbox
+	 *
+	 * The matrix has \f$m\times n\f$ blocks of size \f$b\times b\f$; block
+	 * \f$(i,j)\f$ is \f$T_{i-j+n-1}\f$ for a generator
+	 * \f$T_0,\dots,T_{m+n-2}\f$, so that \f$T_0\f$ is the top right block.
+	 * Copies share the precomputed transforms and applies are reentrant.
+	 */
+	template <class _Field>
+	class FFTBlockToeplitz : public BlackboxInterface {
+	public:
+		typedef _Field                     Field;
+		typedef typename Field::Element  Element;
+		typedef FFTBlockToeplitz<Field>   Self_t;
+
+		/** Constructor from the \f$m+n-1\f$ blocks of the generator.
+		 * @param F field
+		 * @param T generator, square blocks of the same size
+		 * @param m number of block rows
+		 * @param n number of block columns, \p m if 0
+		 */
+		FFTBlockToeplitz (const Field& F, const std::vector<BlasMatrix<Field> >& T, size_t m, size_t n = 0) :
+			_field(&F), _b(T.empty() ? 0 : T[0].rowdim()), _m(m), _n(n ? n : m)
+		{
+			linbox_check(T.size() == _m+_n-1);
+			_gen.resize(T.size()*_b*_b);
+			for (size_t k = 0; k < T.size(); ++k) {
+				linbox_check(T[k].rowdim() == _b && T[k].coldim() == _b);
+				for (size_t r = 0; r < _b; ++r)
+					for (size_t c = 0; c < _b; ++c)
+						_gen[(k*_b+r)*_b+c] = T[k].getEntry(r, c);
+			}
+			_init();
+		}
+
+		template<typename _Tp1>
+		struct rebind {
+			typedef FFTBlockToeplitz<_Tp1> other;
+		};
+
+		/// Same matrix over another field.
+		template<typename _Tp1>
+		FFTBlockToeplitz (const FFTBlockToeplitz<_Tp1>& A, const Field& F) :
+			_field(&F), _b(A.blockdim()), _m(A.rowdim()/A.blockdim()), _n(A.coldim()/A.blockdim())
+		{
+			Hom<_Tp1, Field> hom(A.field(), F);
+			_gen.resize(A.generator().size());
+			for (size_t k = 0; k < _gen.size(); ++k)
+				hom.image(_gen[k], A.generator()[k]);
+			_init();
+		}
+
+		//! y = A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			std::vector<uint64_t> xx(coldim()), yy(rowdim());
+			for (size_t j = 0; j < coldim(); ++j) xx[j] = (uint64_t)x[j];
+			_mul(yy.data(), xx.data(), 1, false);
+			for (size_t i = 0; i < rowdim(); ++i) field().init(y[i], yy[i]);
+			return y;
+		}
+
+		//! y = A^T x
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			std::vector<uint64_t> xx(rowdim()), yy(coldim());
+			for (size_t i = 0; i < rowdim(); ++i) xx[i] = (uint64_t)x[i];
+			_mul(yy.data(), xx.data(), 1, true);
+			for (size_t j = 0; j < coldim(); ++j) field().init(y[j], yy[j]);
+			return y;
+		}
+
+		/** Block product \f$ Y \gets A X \f$: the columns of \p X share the
+		 * transforms of the generator and the pointwise products.
+		 */
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			const size_t w = X.coldim();
+			std::vector<uint64_t> xx(w*coldim()), yy(w*rowdim());
+			for (size_t v = 0; v < w; ++v)
+				for (size_t j = 0; j < coldim(); ++j)
+					xx[v*coldim()+j] = (uint64_t)X.getEntry(j, v);
+			_mul(yy.data(), xx.data(), w, false);
+			for (size_t v = 0; v < w; ++v)
+				for (size_t i = 0; i < rowdim(); ++i)
+					field().init(Y.refEntry(i, v), yy[v*rowdim()+i]);
+			return Y;
+		}
+
+		/// Block product \f$ Y \gets X A \f$.
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			const size_t w = X.rowdim();
+			std::vector<uint64_t> xx(w*rowdim()), yy(w*coldim());
+			for (size_t v = 0; v < w; ++v)
+				for (size_t i = 0; i < rowdim(); ++i)
+					xx[v*rowdim()+i] = (uint64_t)X.getEntry(v, i);
+			_mul(yy.data(), xx.data(), w, true);
+			for (size_t v = 0; v < w; ++v)
+				for (size_t j = 0; j < coldim(); ++j)
+					field().init(Y.refEntry(v, j), yy[v*coldim()+j]);
+			return Y;
+		}
+
+		size_t rowdim () const { return _m*_b; }
+		size_t coldim () const { return _n*_b; }
+		size_t blockdim () const { return _b; }
+		const Field& field () const { return *_field; }
+
+		/// Generator, block after block, each block row major.
+		const std::vector<Element>& generator () const { return _gen; }
+
+		/// Number of FFT primes used for the convolutions.
+		size_t nbPrimes () const { return _fft->fields.size(); }
+
+	protected:
+		typedef Givaro::Modular<uint32_t>      QField;
+		typedef FFT_transform<QField>       Transform;
+		typedef typename Transform::VECT         VECT;
+
+		// Precomputations, shared by the copies of the blackbox.
+		struct Transforms {
+			size_t lpts, pts;
+			std::vector<QField>                       fields;
+			std::vector<std::unique_ptr<Transform> > dir, inv;
+			std::vector<uint64_t>                     invpts; // 1/pts mod q_l
+			std::vector<uint64_t>                      cinv;  // 1/(q_0...q_{l-1}) mod q_l
+			// transforms of the generator (gen) and of the generator of the transpose (tgen),
+			// entry (r,c) at offset (r*b+c)*pts
+			std::vector<VECT>                     gen, tgen;
+		};
+
+		const Field                     *_field;
+		size_t                        _b, _m, _n;
+		std::vector<Element>                _gen;
+		std::shared_ptr<Transforms>         _fft;
+		uint64_t                              _p;
+
+		void _init ()
+		{
+			integer c; field().characteristic(c);
+			linbox_check(c.bitsize() <= 32);
+			_p = (uint64_t)c;
+
+			_fft = std::make_shared<Transforms>();
+			Transforms& D = *_fft;
+			const size_t L = _m+_n-1;
+			D.lpts = 1; D.pts = 2;
+			while (D.pts < L) { D.pts <<= 1; ++D.lpts; }
+
+			std::vector<integer> primes;
+			if (_p < (1UL<<29) && (_p-1) % D.pts == 0)
+				primes.push_back(c);
+			else {
+				integer bound = integer((uint64_t)std::max(_m,_n)*_b) * integer(_p-1) * integer(_p-1);
+				if (! RandomFFTPrime::generatePrimes(primes, integer(1UL<<29), bound, D.lpts))
+					throw LinboxError("LinBox ERROR: not enough FFT primes for FFTBlockToeplitz\n");
+			}
+
+			D.fields.reserve(primes.size());
+			for (size_t l = 0; l < primes.size(); ++l)
+				D.fields.push_back(QField((uint32_t)(uint64_t)primes[l]));
+
+			for (size_t l = 0; l < D.fields.size(); ++l) {
+				const uint64_t q = D.fields[l].characteristic();
+				D.dir.emplace_back(new Transform(D.fields[l], D.lpts));
+				D.inv.emplace_back(new Transform(D.fields[l], D.lpts, D.dir[l]->getInvRoot()));
+				D.invpts.push_back(Givaro::powmod((uint64_t)D.pts, q-2, q));
+				uint64_t pr = 1;
+				for (size_t j = 0; j < l; ++j)
+					pr = pr * D.fields[j].characteristic() % q;
+				D.cinv.push_back(l ? Givaro::powmod(pr, q-2, q) : 1);
+
+				VECT G(_b*_b*D.pts, 0), TG(_b*_b*D.pts, 0);
+				for (size_t k = 0; k < L; ++k)
+					for (size_t r = 0; r < _b; ++r)
+						for (size_t cc = 0; cc < _b; ++cc) {
+							const uint32_t e = (uint32_t)((uint64_t)_gen[(k*_b+r)*_b+cc] % q);
+							G [(r*_b+cc)*D.pts + k]       = e;
+							TG[(cc*_b+r)*D.pts + L-1-k]   = e;
+						}
+				for (size_t i = 0; i < _b*_b; ++i) {
+					D.dir[l]->FFT_DIF(G.data() + i*D.pts);
+					D.dir[l]->FFT_DIF(TG.data() + i*D.pts);
+				}
+				D.gen.push_back(std::move(G));
+				D.tgen.push_back(std::move(TG));
+			}
+		}
+
+		/* y = A x, or A^T x, for w vectors stored one after the other,
+		 * with entries in [0,p). Vector v of y is the middle of the
+		 * convolution of the generator with vector v of x.
+		 */
+		void _mul (uint64_t* y, const uint64_t* x, size_t w, bool trans) const
+		{
+			Transforms& D = *_fft;
+			const size_t N = D.pts, b = _b, np = D.fields.size();
+			const size_t nin  = (trans ? _m : _n), nout = (trans ? _n : _m);
+			const size_t sin  = nin*b, sout = nout*b;
+			std::vector<uint64_t> res(np*w*sout);
+
+			for (size_t l = 0; l < np; ++l) {
+				const uint64_t q = D.fields[l].characteristic();
+				const VECT& G = trans ? D.tgen[l] : D.gen[l];
+				VECT X(w*b*N, 0), Y(w*b*N);
+
+				for (size_t v = 0; v < w; ++v)
+					for (size_t j = 0; j < nin; ++j)
+						for (size_t c = 0; c < b; ++c)
+							X[(v*b+c)*N + j] = (uint32_t)(x[v*sin + j*b+c] % q);
+				for (size_t i = 0; i < w*b; ++i)
+					D.dir[l]->FFT_DIF(X.data() + i*N);
+
+				// pointwise b x b by b x w products
+				for (size_t v = 0; v < w; ++v)
+					for (size_t r = 0; r < b; ++r) {
+						uint32_t* Yr = Y.data() + (v*b+r)*N;
+						for (size_t k = 0; k < N; ++k) {
+							uint64_t acc = 0;
+							for (size_t c = 0; c < b; ++c)
+								acc = (acc + (uint64_t)G[(r*b+c)*N + k] * X[(v*b+c)*N + k]) % q;
+							Yr[k] = (uint32_t)acc;
+						}
+					}
+
+				for (size_t i = 0; i < w*b; ++i)
+					D.inv[l]->FFT_DIT(Y.data() + i*N);
+
+				uint64_t* R = res.data() + l*w*sout;
+				for (size_t v = 0; v < w; ++v)
+					for (size_t i = 0; i < nout; ++i)
+						for (size_t r = 0; r < b; ++r)
+							R[v*sout + i*b+r] = Y[(v*b+r)*N + nin-1+i] * D.invpts[l] % q;
+			}
+
+			// Garner reconstruction modulo p
+			std::vector<uint64_t> cf(np);
+			for (size_t k = 0; k < w*sout; ++k) {
+				for (size_t l = 0; l < np; ++l) {
+					const uint64_t q = D.fields[l].characteristic();
+					uint64_t t = 0;
+					for (size_t j = l; j-- > 0; )
+						t = (t * D.fields[j].characteristic() + cf[j]) % q;
+					cf[l] = (res[l*w*sout + k] + q - t) % q * D.cinv[l] % q;
+				}
+				uint64_t s = 0;
+				for (size_t j = np; j-- > 0; )
+					s = (s * D.fields[j].characteristic() + cf[j]) % _p;
+				y[k] = s;
+			}
+		}
+	};
+
+	/** \brief Toeplitz blackbox applied by FFT.
+	 * \ingroup blackbox
+	 *
+	 * Entry \f$(i,j)\f$ is \f$t_{i-j+n-1}\f$: \f$t_0\f$ is the top right
+	 * entry, as for Toeplitz.
+	 */
+	template <class _Field>
+	class FFTToeplitz : public FFTBlockToeplitz<_Field> {
+	public:
+		typedef _Field                     Field;
+		typedef typename Field::Element  Element;
+		typedef FFTBlockToeplitz<Field>  Father_t;
+
+		/** Constructor from the \f$m+n-1\f$ coefficients of the generator.
+		 * @param m row dimension
+		 * @param n column dimension, \p m if 0
+		 */
+		FFTToeplitz (const Field& F, const std::vector<Element>& t, size_t m, size_t n = 0) :
+			Father_t(F, _blocks(F, t), m, n)
+		{}
+
+		/// Square \f$n\times n\f$ matrix from \f$2n-1\f$ coefficients.
+		FFTToeplitz (const Field& F, const std::vector<Element>& t) :
+			Father_t(F, _blocks(F, t), (t.size()+1)/2)
+		{
+			linbox_check(t.size() & 1);
+		}
+
+		template<typename _Tp1>
+		struct rebind {
+			typedef FFTToeplitz<_Tp1> other;
+		};
+
+		template<typename _Tp1>
+		FFTToeplitz (const FFTToeplitz<_Tp1>& A, const Field& F) :
+			Father_t(A, F)
+		{}
+
+	protected:
+		static std::vector<BlasMatrix<Field> > _blocks (const Field& F, const std::vector<Element>& t)
+		{
+			std::vector<BlasMatrix<Field> > T(t.size(), BlasMatrix<Field>(F, 1, 1));
+			for (size_t k = 0; k < t.size(); ++k)
+				T[k].setEntry(0, 0, t[k]);
+			return T;
+		}
+	};
+
+	/** \brief Hankel blackbox applied by FFT.
+	 * \ingroup blackbox
+	 *
+	 * Entry \f$(i,j)\f$ is \f$h_{i+j}\f$. The Hankel matrix is the Toeplitz
+	 * matrix of the same generator with its columns in reverse order.
+	 */
+	template <class _Field>
+	class FFTHankel : public BlackboxInterface {
+	public:
+		typedef _Field                     Field;
+		typedef typename Field::Element  Element;
+		typedef FFTHankel<Field>          Self_t;
+
+		/** Constructor from the \f$m+n-1\f$ coefficients of the generator.
+		 * @param m row dimension
+		 * @param n column dimension, \p m if 0
+		 */
+		FFTHankel (const Field& F, const std::vector<Element>& h, size_t m, size_t n = 0) :
+			_T(F, h, m, n)
+		{}
+
+		template<typename _Tp1>
+		struct rebind {
+			typedef FFTHankel<_Tp1> other;
+		};
+
+		template<typename _Tp1>
+		FFTHankel (const FFTHankel<_Tp1>& A, const Field& F) :
+			_T(A.toeplitz(), F)
+		{}
+
+		//! y = A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			std::vector<Element> rx(coldim());
+			for (size_t j = 0; j < coldim(); ++j)
+				rx[j] = x[coldim()-1-j];
+			return _T.apply(y, rx);
+		}
+
+		//! y = A^T x
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			std::vector<Element> ry(coldim());
+			_T.applyTranspose(ry, x);
+			for (size_t j = 0; j < coldim(); ++j)
+				field().assign(y[j], ry[coldim()-1-j]);
+			return y;
+		}
+
+		/// Block product \f$ Y \gets A X \f$.
+		template<class Matrix>
+		Matrix& applyLeft (Matrix& Y, const Matrix& X) const
+		{
+			Matrix RX(field(), X.rowdim(), X.coldim());
+			for (size_t j = 0; j < X.rowdim(); ++j)
+				for (size_t v = 0; v < X.coldim(); ++v)
+					RX.setEntry(j, v, X.getEntry(X.rowdim()-1-j, v));
+			return _T.applyLeft(Y, RX);
+		}
+
+		/// Block product \f$ Y \gets X A \f$.
+		template<class Matrix>
+		Matrix& applyRight (Matrix& Y, const Matrix& X) const
+		{
+			Matrix RY(field(), Y.rowdim(), Y.coldim());
+			_T.applyRight(RY, X);
+			for (size_t v = 0; v < Y.rowdim(); ++v)
+				for (size_t j = 0; j < Y.coldim(); ++j)
+					Y.setEntry(v, j, RY.getEntry(v, Y.coldim()-1-j));
+			return Y;
+		}
+
+		size_t rowdim () const { return _T.rowdim(); }
+		size_t coldim () const { return _T.coldim(); }
+		const Field& field () const { return _T.field(); }
+
+		/// Toeplitz matrix with the same generator.
+		const FFTToeplitz<Field>& toeplitz () const { return _T; }
+
+	protected:
+		FFTToeplitz<Field> _T;
+	};
+
+	template <class Field>
+	struct is_blockbb<FFTBlockToeplitz<Field> > {
+		static const bool value = true;
+	};
+
+	template <class Field>
+	struct is_blockbb<FFTToeplitz<Field> > {
+		static const bool value = true;
+	};
+
+	template <class Field>
+	struct is_blockbb<FFTHankel<Field> > {
+		static const bool value = true;
+	};
+
+}
+
+#endif // __LINBOX_fft_toeplitz_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
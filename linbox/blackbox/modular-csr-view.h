@@ -0,0 +1,276 @@
+/* linbox/blackbox/modular-csr-view.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/modular-csr-view.h
+ * @ingroup blackbox
+ * @brief Modular view of an integer sparse matrix, reduced on apply.
+ *
+ * CRA iterations usually rebind the integer blackbox to the field of the
+ * current prime, which copies and converts the whole matrix for every
+ * prime, in every thread. When the entries fit in a machine word, the
+ * matrix can instead be stored once as an \c int64_t CSR (IntegerCSRImage)
+ * shared by all iterations, and viewed modulo each prime by a
+ * ModularCSRView which reduces the entries on the fly inside
+ * \c apply and \c applyTranspose. A view only costs \f$O(1)\f$ memory.
+ */
+
+#ifndef __LINBOX_modular_csr_view_H
+#define __LINBOX_modular_csr_view_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/matrix/sparse-matrix.h"
+#include "linbox/solutions/methods.h"
+
+namespace LinBox
+{
+
+	/** \brief Shared word size CSR copy of an integer sparse matrix.
+	 *
+	 * Built once, read concurrently by any number of ModularCSRView.
+	 */
+	class IntegerCSRImage {
+	public:
+		IntegerCSRImage () :
+			_m(0), _n(0), _fits(false), _maxNorm(0)
+		{}
+
+		/** Builds the image of any matrix providing \c IndexedBegin() / \c IndexedEnd().
+		 * If an entry does not fit in 62 bits, fits() is false and the image is empty.
+		 */
+		template<class Matrix>
+		bool assign (const Matrix& A)
+		{
+			_m = A.rowdim(); _n = A.coldim();
+			_start.assign(_m+1, 0);
+			_colid.clear(); _data.clear();
+			_fits = true;
+			_maxNorm = 0;
+
+			integer e;
+			for (auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+				A.field().convert(e, it.value());
+				if (e.bitsize() > 62) {
+					_fits = false;
+					_start.clear();
+					return false;
+				}
+				++_start[it.rowIndex()+1];
+			}
+			for (size_t i = 0; i < _m; ++i)
+				_start[i+1] += _start[i];
+
+			_colid.resize(_start[_m]);
+			_data.resize(_start[_m]);
+			std::vector<size_t> pos(_start.begin(), _start.end()-1);
+			for (auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+				A.field().convert(e, it.value());
+				size_t k = pos[it.rowIndex()]++;
+				_colid[k] = it.colIndex();
+				_data[k]  = (int64_t)e;
+				_maxNorm  = std::max(_maxNorm, (uint64_t)std::abs(_data[k]));
+			}
+			return true;
+		}
+
+		bool fits () const { return _fits; }
+
+		size_t rowdim () const { return _m; }
+		size_t coldim () const { return _n; }
+		size_t size () const { return _data.size(); }
+		//! Largest absolute value of the entries.
+		uint64_t maxNorm () const { return _maxNorm; }
+
+		const std::vector<size_t>&  start () const { return _start; }
+		const std::vector<size_t>&  colid () const { return _colid; }
+		const std::vector<int64_t>& data  () const { return _data; }
+
+	protected:
+		size_t                 _m, _n;
+		bool                    _fits;
+		uint64_t             _maxNorm;
+		std::vector<size_t>    _start;
+		std::vector<size_t>    _colid;
+		std::vector<int64_t>    _data;
+	};
+
+	/** \brief Blackbox view of an IntegerCSRImage modulo the characteristic of a field.
+	 * \ingroup blackbox
+	 *
+	 * Entries are reduced by Barrett reduction when the characteristic
+	 * fits in 32 bits, by \c Field::init otherwise. Apply is reentrant.
+	 */
+	template <class Field_>
+	class ModularCSRView : public BlackboxInterface {
+	public:
+		typedef Field_                      Field;
+		typedef typename Field::Element   Element;
+		typedef ModularCSRView<Field>      Self_t;
+
+		ModularCSRView (const IntegerCSRImage& I, const Field& F) :
+			_image(&I), _field(&F)
+		{
+			linbox_check(I.fits());
+			_initReduction();
+		}
+
+		template<typename _Tp1>
+		struct rebind {
+			typedef ModularCSRView<_Tp1> other;
+		};
+
+		/// Another view of the same image.
+		template<typename _Tp1>
+		ModularCSRView (const ModularCSRView<_Tp1>& A, const Field& F) :
+			_image(&A.image()), _field(&F)
+		{
+			_initReduction();
+		}
+
+		//! y = A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			const Field& F = field();
+			const std::vector<size_t>&  st = _image->start();
+			const std::vector<size_t>&  ci = _image->colid();
+			const std::vector<int64_t>& da = _image->data();
+			Element a;
+			for (size_t i = 0; i < rowdim(); ++i) {
+				F.assign(y[i], F.zero);
+				for (size_t k = st[i]; k < st[i+1]; ++k) {
+					reduce(a, da[k]);
+					F.axpyin(y[i], a, x[ci[k]]);
+				}
+			}
+			return y;
+		}
+
+		//! y = A^T x
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			const Field& F = field();
+			const std::vector<size_t>&  st = _image->start();
+			const std::vector<size_t>&  ci = _image->colid();
+			const std::vector<int64_t>& da = _image->data();
+			Element a;
+			for (size_t j = 0; j < coldim(); ++j)
+				F.assign(y[j], F.zero);
+			for (size_t i = 0; i < rowdim(); ++i)
+				for (size_t k = st[i]; k < st[i+1]; ++k) {
+					reduce(a, da[k]);
+					F.axpyin(y[ci[k]], a, x[i]);
+				}
+			return y;
+		}
+
+		//! a = v mod p
+		Element& reduce (Element& a, int64_t v) const
+		{
+			if (! _barrett)
+				return field().init(a, v);
+			uint64_t u = (v < 0) ? (uint64_t)0-(uint64_t)v : (uint64_t)v;
+			uint64_t q = (uint64_t)(((unsigned __int128)u * _inv) >> 64);
+			uint64_t r = u - q*_p;
+			if (r >= _p) r -= _p;
+			field().init(a, r);
+			return (v < 0) ? field().negin(a) : a;
+		}
+
+		size_t rowdim () const { return _image->rowdim(); }
+		size_t coldim () const { return _image->coldim(); }
+		size_t size () const { return _image->size(); }
+
+		const Field& field () const { return *_field; }
+		const IntegerCSRImage& image () const { return *_image; }
+
+	protected:
+		const IntegerCSRImage *_image;
+		const Field           *_field;
+		bool                 _barrett;
+		uint64_t                   _p;
+		uint64_t                 _inv; //!< floor((2^64-1)/p)
+
+		void _initReduction ()
+		{
+			integer c; field().characteristic(c);
+			_barrett = (c > 1) && (c.bitsize() <= 32);
+			_p   = _barrett ? (uint64_t)c : 0;
+			_inv = _barrett ? ~(uint64_t)0 / _p : 0;
+		}
+	};
+
+	//! @internal Whether \p Matrix has the const \c IndexedBegin() IntegerCSRImage::assign reads.
+	template<class Matrix, class = void>
+	struct HasIndexedIterator : std::false_type {};
+
+	template<class Matrix>
+	struct HasIndexedIterator<Matrix, decltype((void)std::declval<const Matrix&>().IndexedBegin())> : std::true_type {};
+
+	/*! @internal Whether the per prime images of a \p Blackbox in a CRA
+	 * iteration using \p MyMethod may be ModularCSRView.
+	 * Only sparse matrices with indexed iteration (not HYB, TPL or SMM),
+	 * with pure blackbox methods, which never modify the matrix, qualify.
+	 */
+	template<class Blackbox, class MyMethod>
+	struct UseModularCSRView : std::false_type {};
+
+	template<class Ring, class Format>
+	struct UseModularCSRView<SparseMatrix<Ring,Format>, Method::Blackbox> : HasIndexedIterator<SparseMatrix<Ring,Format> > {};
+
+	template<class Ring, class Format>
+	struct UseModularCSRView<SparseMatrix<Ring,Format>, Method::Wiedemann> : HasIndexedIterator<SparseMatrix<Ring,Format> > {};
+
+	//! @internal Builds \p I from \p A when UseModularCSRView holds.
+	template<class Matrix>
+	bool initCSRImage (IntegerCSRImage& I, const Matrix& A, std::true_type)
+	{
+		return I.assign(A);
+	}
+
+	template<class Matrix>
+	bool initCSRImage (IntegerCSRImage&, const Matrix&, std::false_type)
+	{
+		return false;
+	}
+
+}
+
+#endif // __LINBOX_modular_csr_view_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,235 @@
+/* linbox/blackbox/multimod-csr-view.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/multimod-csr-view.h
+ * @ingroup blackbox
+ * @brief View of an integer sparse matrix modulo several primes at once.
+ *
+ * A sparse matrix vector product is bound by the memory traffic of the
+ * index structure rather than by the arithmetic. A MultiModCSRView
+ * reads the IntegerCSRImage of the matrix once per apply and multiplies
+ * it by \c k vectors, one modulo each prime of a MultiModDouble: the \c k
+ * residues of each nonzero are processed together, by a loop the
+ * compiler vectorises.
+ *
+ * Vectors are packed: the residue modulo the \c l -th prime of the
+ * \c j -th coordinate is at position \c j*k+l of a contiguous array of
+ * \c double, in \f$[0,p_l)\f$.
+ */
+
+#ifndef __LINBOX_multimod_csr_view_H
+#define __LINBOX_multimod_csr_view_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/field/multimod-field.h"
+#include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/modular-csr-view.h"
+
+namespace LinBox
+{
+
+	/** \brief Blackbox view of an IntegerCSRImage modulo all the primes of a MultiModDouble.
+	 * \ingroup blackbox
+	 *
+	 * Products are accumulated in \c double and reduced only when the
+	 * next one could exceed \f$2^{53}\f$. Entries smaller than all the
+	 * primes are used as they are; otherwise their residues are computed
+	 * once, when the view is built. Apply is reentrant.
+	 */
+	class MultiModCSRView : public BlackboxInterface {
+	public:
+		typedef MultiModDouble              Field;
+		typedef Field::Element            Element;
+		typedef std::vector<double>  PackedVector;
+		typedef MultiModCSRView            Self_t;
+
+		MultiModCSRView (const IntegerCSRImage& I, const Field& F) :
+			_image(&I), _field(&F), _k(F.size()), _moduli(F.size())
+		{
+			linbox_check(I.fits());
+			double pmin = 0.;
+			for (size_t l = 0; l < _k; ++l) {
+				_moduli[l] = (double)F.getModulo(l);
+				pmin = (l == 0) ? _moduli[l] : std::min(pmin, _moduli[l]);
+			}
+
+			_delay = F.delayBound();
+			linbox_check(_delay > 0);
+
+			if ((double)I.maxNorm() >= pmin) {
+				const std::vector<int64_t>& da = I.data();
+				_residues.resize(da.size() * _k);
+				for (size_t t = 0; t < da.size(); ++t)
+					for (size_t l = 0; l < _k; ++l)
+						F.getBase(l).init(_residues[t*_k+l], integer(da[t]));
+			}
+		}
+
+		//! Number of primes.
+		size_t moduli () const { return _k; }
+
+		//! y = A x, packed vectors
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			const std::vector<size_t>&  st = _image->start();
+			const std::vector<size_t>&  ci = _image->colid();
+			const std::vector<int64_t>& da = _image->data();
+			const bool small = _residues.empty();
+			const double *xp = &x[0];
+			std::vector<double> acc(_k);
+
+			for (size_t i = 0; i < rowdim(); ++i) {
+				std::fill(acc.begin(), acc.end(), 0.);
+				size_t pending = 0;
+				for (size_t t = st[i]; t < st[i+1]; ++t) {
+					const double *xj = xp + ci[t]*_k;
+					if (small) {
+						const double a = (double)da[t];
+						for (size_t l = 0; l < _k; ++l)
+							acc[l] += a * xj[l];
+					}
+					else {
+						const double *a = &_residues[t*_k];
+						for (size_t l = 0; l < _k; ++l)
+							acc[l] += a[l] * xj[l];
+					}
+					if (++pending == _delay) {
+						reduce(&acc[0]);
+						pending = 0;
+					}
+				}
+				reduce(&acc[0]);
+				for (size_t l = 0; l < _k; ++l)
+					y[i*_k+l] = acc[l];
+			}
+			return y;
+		}
+
+		//! y = A^T x, packed vectors
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			const std::vector<size_t>&  st = _image->start();
+			const std::vector<size_t>&  ci = _image->colid();
+			const std::vector<int64_t>& da = _image->data();
+			const bool small = _residues.empty();
+			std::vector<size_t> pending(coldim(), 0);
+
+			for (size_t j = 0; j < coldim()*_k; ++j)
+				y[j] = 0.;
+			for (size_t i = 0; i < rowdim(); ++i) {
+				const double *xi = &x[i*_k];
+				for (size_t t = st[i]; t < st[i+1]; ++t) {
+					double *yj = &y[ci[t]*_k];
+					if (small) {
+						const double a = (double)da[t];
+						for (size_t l = 0; l < _k; ++l)
+							yj[l] += a * xi[l];
+					}
+					else {
+						const double *a = &_residues[t*_k];
+						for (size_t l = 0; l < _k; ++l)
+							yj[l] += a[l] * xi[l];
+					}
+					if (++pending[ci[t]] == _delay) {
+						reduce(yj);
+						pending[ci[t]] = 0;
+					}
+				}
+			}
+			for (size_t j = 0; j < coldim(); ++j)
+				reduce(&y[j*_k]);
+			return y;
+		}
+
+		//! r[l] = x_l . y_l mod p_l, for packed vectors of length \p n
+		template<class InVector1, class InVector2>
+		std::vector<double>& dot (std::vector<double>& r, const InVector1& x, const InVector2& y, size_t n) const
+		{
+			r.assign(_k, 0.);
+			size_t pending = 0;
+			for (size_t j = 0; j < n; ++j) {
+				const double *xj = &x[j*_k], *yj = &y[j*_k];
+				for (size_t l = 0; l < _k; ++l)
+					r[l] += xj[l] * yj[l];
+				if (++pending == _delay) {
+					reduce(&r[0]);
+					pending = 0;
+				}
+			}
+			reduce(&r[0]);
+			return r;
+		}
+
+		//! x_l = d_l * x_l mod p_l, coordinatewise, for packed vectors of length \p n
+		template<class InOutVector, class InVector>
+		InOutVector& scalein (InOutVector& x, const InVector& d, size_t n) const
+		{
+			for (size_t j = 0; j < n; ++j) {
+				for (size_t l = 0; l < _k; ++l)
+					x[j*_k+l] *= d[j*_k+l];
+				reduce(&x[j*_k]);
+			}
+			return x;
+		}
+
+		//! a[l] mod p_l, in [0, p_l), for the \c k values at \p a
+		void reduce (double *a) const
+		{
+			_field->reduce(a);
+		}
+
+		size_t rowdim () const { return _image->rowdim(); }
+		size_t coldim () const { return _image->coldim(); }
+		size_t size () const { return _image->size(); }
+
+		const Field& field () const { return *_field; }
+		const IntegerCSRImage& image () const { return *_image; }
+
+	protected:
+		const IntegerCSRImage *_image;
+		const Field           *_field;
+		size_t                     _k;
+		std::vector<double>   _moduli;
+		size_t                 _delay; //!< products accumulated between two reductions
+		std::vector<double> _residues; //!< packed residues of the entries, empty when they are small
+	};
+
+}
+
+#endif // __LINBOX_multimod_csr_view_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,442 @@
+/* linbox/blackbox/signed-zo.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file blackbox/signed-zo.h
+ * @ingroup blackbox
+ * @brief Sparse matrices with entries 0, 1 and -1, applied with additions only.
+ *
+ * Incidence and adjacency matrices have no values to store: a
+ * SignedZeroOne keeps, for each row, the columns of its 1 entries and
+ * then those of its -1 entries, as 32 bit indices, in the implicit
+ * value CSR format (SparseMatrixFormat::CSR1). The transpose is
+ * stored as well, so that \c applyTranspose reads rows too.
+ *
+ * Over \c Givaro::Modular and \c Givaro::ModularBalanced, the vector
+ * is first converted to \c int64_t, or \c double for floating point
+ * elements. A row is then a sum of gathered coordinates, which the
+ * compiler vectorises, reduced only when the next addition could
+ * overflow. The conversions and the rows are shared between threads,
+ * and the converted vectors are kept from one apply to the next (see
+ * ApplyWorkspace).
+ */
+
+#ifndef __LINBOX_signed_zero_one_H
+#define __LINBOX_signed_zero_one_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "linbox/linbox-config.h"
+#include "linbox/integer.h"
+#include "linbox/util/debug.h"
+#include "linbox/util/error.h"
+#include "linbox/ring/modular.h"
+#include "linbox/matrix/matrix-category.h"
+#include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/blockbb.h"
+#include "linbox/blackbox/apply-workspace.h"
+#include "linbox/matrix/matrixdomain/blas-parallelism.h"
+
+#ifndef LINBOX_ZERO_ONE_GRAIN
+// fewest rows handled by a thread
+#define LINBOX_ZERO_ONE_GRAIN 1024
+#endif
+
+namespace LinBox
+{
+
+	/** \brief Accumulator of the SignedZeroOne additions over \c Field.
+	 *
+	 * \c value is false when the field has no machine word representation,
+	 * the applies then use the field operations.
+	 */
+	template <class Field>
+	struct SignedZeroOneTraits {
+		static const bool value = false;
+		typedef int64_t Accumulator;
+	};
+
+	template <class T>
+	struct SignedZeroOneTraits<Givaro::Modular<T> > {
+		static const bool value = std::is_arithmetic<T>::value;
+		typedef typename std::conditional<std::is_floating_point<T>::value, double, int64_t>::type Accumulator;
+	};
+
+	template <class T>
+	struct SignedZeroOneTraits<Givaro::ModularBalanced<T> > {
+		static const bool value = std::is_arithmetic<T>::value;
+		typedef typename std::conditional<std::is_floating_point<T>::value, double, int64_t>::type Accumulator;
+	};
+
+	/** \brief Positions of the 1 and -1 entries of a matrix, by rows.
+	 *
+	 * Row \c i has its 1 entries in columns \c colid[start[i]..mid[i])
+	 * and its -1 entries in columns \c colid[mid[i]..start[i+1]), both
+	 * increasing.
+	 */
+	struct ZeroOneCSR {
+		typedef uint32_t Index;
+
+		std::vector<size_t> start;
+		std::vector<size_t>   mid;
+		std::vector<Index>  colid;
+
+		size_t rowdim () const { return mid.size(); }
+
+		//! From the coordinates of the entries, \p neg null when there is no -1.
+		void assign (size_t m, size_t nnz, const size_t* rows, const size_t* cols, const bool* neg)
+		{
+			std::vector<size_t> plus(m, 0), minus(m, 0);
+			for (size_t k = 0; k < nnz; ++k)
+				++((neg && neg[k]) ? minus : plus)[rows[k]];
+			start.assign(m+1, 0);
+			mid.resize(m);
+			for (size_t i = 0; i < m; ++i) {
+				mid[i] = start[i] + plus[i];
+				start[i+1] = mid[i] + minus[i];
+				plus[i] = start[i];
+				minus[i] = mid[i];
+			}
+			colid.resize(nnz);
+			for (size_t k = 0; k < nnz; ++k)
+				colid[((neg && neg[k]) ? minus : plus)[rows[k]]++] = (Index)cols[k];
+			for (size_t i = 0; i < m; ++i) {
+				std::sort(colid.begin()+(ptrdiff_t)start[i], colid.begin()+(ptrdiff_t)mid[i]);
+				std::sort(colid.begin()+(ptrdiff_t)mid[i], colid.begin()+(ptrdiff_t)start[i+1]);
+			}
+		}
+	};
+
+	/** \brief Blackbox of a sparse matrix with entries 0, 1 and -1.
+	 * \ingroup blackbox
+	 *
+	 * Unlike ZeroOne, the matrix is never re-sorted: apply is reentrant.
+	 * Copies and rebinds share the indices. The block applies make it
+	 * a block blackbox for block Wiedemann.
+	 */
+	template <class _Field>
+	class SignedZeroOne : public BlackboxInterface {
+	public:
+		typedef _Field                           Field;
+		typedef typename Field::Element        Element;
+		typedef SignedZeroOne<Field>            Self_t;
+		typedef ZeroOneCSR::Index                Index;
+		typedef typename SignedZeroOneTraits<Field>::Accumulator Accumulator;
+		typedef MatrixCategories::BlackboxTag MatrixCategory;
+
+		/** From the coordinates of the \p NNz nonzero entries, which are 1,
+		 * or -1 when \p neg is given and \p neg[k] is true.
+		 * Coordinates must be distinct.
+		 * @throws LinboxError when a dimension does not fit in 32 bits.
+		 */
+		SignedZeroOne (const Field& F, const size_t* rowP, const size_t* colP,
+			       size_t rows, size_t cols, size_t NNz, const bool* neg = nullptr) :
+			_field(&F), _rowdim(rows), _coldim(cols), _par(0)
+		{
+			_build(rowP, colP, NNz, neg);
+		}
+
+		/** From any matrix providing \c IndexedBegin() / \c IndexedEnd(),
+		 * over any ring, whose entries are 0, 1 or -1.
+		 * @throws LinboxError for other entries, or a dimension not fitting in 32 bits.
+		 */
+		template <class Matrix>
+		SignedZeroOne (const Field& F, const Matrix& A) :
+			_field(&F), _rowdim(A.rowdim()), _coldim(A.coldim()), _par(0)
+		{
+			std::vector<size_t> rows, cols;
+			std::vector<char> neg;
+			for (auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it) {
+				if (A.field().isZero(it.value()))
+					continue;
+				if (! A.field().isOne(it.value()) && ! A.field().isMOne(it.value()))
+					throw LinboxError("SignedZeroOne: entry other than 0, 1 or -1");
+				rows.push_back(it.rowIndex());
+				cols.push_back(it.colIndex());
+				neg.push_back(A.field().isMOne(it.value()));
+			}
+			std::unique_ptr<bool[]> n(new bool[neg.size()+1]);
+			std::copy(neg.begin(), neg.end(), n.get());
+			_build(rows.data(), cols.data(), rows.size(), n.get());
+		}
+
+		template<typename _Tp1>
+		struct rebind {
+			typedef SignedZeroOne<_Tp1> other;
+			void operator() (other *& Ap, const Self_t& A, const _Tp1& F)
+			{
+				Ap = new other(A, F);
+			}
+		};
+
+		/// The same matrix over another field, sharing the indices.
+		template<typename _Tp1>
+		SignedZeroOne (const SignedZeroOne<_Tp1>& A, const Field& F) :
+			_field(&F), _rowdim(A.rowdim()), _coldim(A.coldim()), _rows(A.rows()), _cols(A.cols()), _par(A.threads())
+		{
+			_initReduction();
+		}
+
+		//! y = A x
+		template<class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			linbox_check((y.size() == rowdim()) && (x.size() == coldim()));
+			_apply(*_rows, _coldim, 1, [&](size_t j, size_t) -> const Element& { return x[j]; },
+			       [&](size_t i, size_t, const Element& e) { y[i] = e; }, _fast());
+			return y;
+		}
+
+		//! y = A^T x
+		template<class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			linbox_check((y.size() == coldim()) && (x.size() == rowdim()));
+			_apply(*_cols, _rowdim, 1, [&](size_t i, size_t) -> const Element& { return x[i]; },
+			       [&](size_t j, size_t, const Element& e) { y[j] = e; }, _fast());
+			return y;
+		}
+
+		//! Y = A X, for the columns of X
+		template<class Matrix1, class Matrix2>
+		Matrix1& applyLeft (Matrix1& Y, const Matrix2& X) const
+		{
+			linbox_check((Y.rowdim() == rowdim()) && (X.rowdim() == coldim()) && (X.coldim() == Y.coldim()));
+			_apply(*_rows, _coldim, X.coldim(), [&](size_t j, size_t c) { return X.getEntry(j, c); },
+			       [&](size_t i, size_t c, const Element& e) { Y.setEntry(i, c, e); }, _fast());
+			return Y;
+		}
+
+		//! Y = X A, for the rows of X
+		template<class Matrix1, class Matrix2>
+		Matrix1& applyRight (Matrix1& Y, const Matrix2& X) const
+		{
+			linbox_check((Y.coldim() == coldim()) && (X.coldim() == rowdim()) && (X.rowdim() == Y.rowdim()));
+			_apply(*_cols, _rowdim, X.rowdim(), [&](size_t i, size_t r) { return X.getEntry(r, i); },
+			       [&](size_t j, size_t r, const Element& e) { Y.setEntry(r, j, e); }, _fast());
+			return Y;
+		}
+
+		size_t rowdim () const { return _rowdim; }
+		size_t coldim () const { return _coldim; }
+		size_t nnz () const { return _rows->colid.size(); }
+
+		const Field& field () const { return *_field; }
+
+		/// Threads of the applies, 0 (the default) for all the available ones (see BlasParallelism).
+		size_t threads () const { return _par.threads(); }
+		void setThreads (size_t threads) { _par.setThreads(threads); }
+
+		//! The positions of the entries, by rows.
+		const std::shared_ptr<const ZeroOneCSR>& rows () const { return _rows; }
+		//! The positions of the entries, by columns.
+		const std::shared_ptr<const ZeroOneCSR>& cols () const { return _cols; }
+
+		std::ostream& write (std::ostream& out = std::cout) const
+		{
+			return out << "SignedZeroOne Matrix: " << _rowdim << "x" << _coldim << ", " << nnz() << " nonzeros";
+		}
+
+	protected:
+		const Field                      *_field;
+		size_t                   _rowdim, _coldim;
+		std::shared_ptr<const ZeroOneCSR> _rows;
+		std::shared_ptr<const ZeroOneCSR> _cols;
+		Accumulator                          _p;
+		size_t                           _delay; //!< additions between two reductions, 0 for the field operations
+		BlasParallelism                    _par;
+
+		typedef std::integral_constant<bool, SignedZeroOneTraits<Field>::value> _fast;
+
+		void _build (const size_t* rows, const size_t* cols, size_t nnz, const bool* neg)
+		{
+			if (_coldim > (size_t)std::numeric_limits<Index>::max() || _rowdim > (size_t)std::numeric_limits<Index>::max())
+				throw LinboxError("SignedZeroOne: dimension too large for 32 bit indices");
+			std::shared_ptr<ZeroOneCSR> R = std::make_shared<ZeroOneCSR>(), C = std::make_shared<ZeroOneCSR>();
+			R->assign(_rowdim, nnz, rows, cols, neg);
+			C->assign(_coldim, nnz, cols, rows, neg);
+			_rows = R;
+			_cols = C;
+			_initReduction();
+		}
+
+		/* |a| < bound for an accumulator a: a reduced value plus delay
+		 * coordinates of absolute value at most p-1, including the
+		 * balanced representations.
+		 */
+		void _initReduction ()
+		{
+			_p = 0; _delay = 0;
+			if (! SignedZeroOneTraits<Field>::value)
+				return;
+			integer c; field().characteristic(c);
+			const uint64_t bound = std::is_floating_point<Accumulator>::value ? ((uint64_t)1 << 53) : (uint64_t)std::numeric_limits<int64_t>::max();
+			if (c < 2 || c.bitsize() > 62 || (uint64_t)c >= bound / 2)
+				return;
+			const uint64_t p = (uint64_t)c;
+			_p = (Accumulator)p;
+			_delay = (size_t)std::min((uint64_t)std::numeric_limits<size_t>::max() / 2, (bound - p) / (p - 1));
+		}
+
+		static int64_t _reduce (int64_t a, int64_t p)
+		{
+			a %= p;
+			return (a < 0) ? a + p : a;
+		}
+
+		static double _reduce (double a, double p)
+		{
+			double r = a - std::floor(a / p) * p;
+			if (r < 0) r += p;
+			else if (r >= p) r -= p;
+			return r;
+		}
+
+		// number of threads for a loop over \p rows rows
+		size_t _threads (size_t rows) const
+		{
+			return std::max((size_t)1, std::min(_par.effective(), rows / LINBOX_ZERO_ONE_GRAIN));
+		}
+
+		/* Out = C In for k vectors of size n: gather(j,c) is the j-th coordinate of
+		 * the c-th input vector, scatter(i,c,e) sets the i-th coordinate
+		 * of the c-th output vector to e.
+		 */
+		template<class Gather, class Scatter>
+		void _apply (const ZeroOneCSR& C, size_t n, size_t k, Gather gather, Scatter scatter, std::true_type) const
+		{
+			if (_delay == 0) {
+				_apply(C, n, k, gather, scatter, std::false_type());
+				return;
+			}
+			const size_t m = C.rowdim();
+			// vectors of the calling thread, kept from one apply to the next
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Accumulator>& X = ws.template elements<Accumulator> (0, n*k);
+			std::vector<Accumulator>& Y = ws.template elements<Accumulator> (1, m*k);
+
+			const size_t tn = _threads(n);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads((int)tn) schedule(static) if (tn > 1)
+#endif
+			for (long jj = 0; jj < (long)n; ++jj) {
+				const size_t j = (size_t)jj;
+				for (size_t c = 0; c < k; ++c)
+					X[j*k+c] = (Accumulator)gather(j, c);
+			}
+			(void)tn;
+
+			const size_t t = _threads(m);
+			const Accumulator p = _p;
+			const size_t delay = _delay;
+			const Index *ci = C.colid.data();
+			const Accumulator *xp = X.data();
+#ifdef _OPENMP
+#pragma omp parallel for num_threads((int)t) schedule(dynamic, LINBOX_ZERO_ONE_GRAIN)
+#endif
+			for (long ii = 0; ii < (long)m; ++ii) {
+				const size_t i = (size_t)ii;
+				Element e;
+				if (k == 1) {
+					// gathered sums of at most delay coordinates
+					Accumulator s = 0;
+					for (size_t a = C.start[i]; a < C.mid[i]; a += delay) {
+						const size_t b = std::min(C.mid[i], a + delay);
+						Accumulator u = 0;
+						for (size_t l = a; l < b; ++l) u += xp[ci[l]];
+						s = _reduce(s + u, p);
+					}
+					for (size_t a = C.mid[i]; a < C.start[i+1]; a += delay) {
+						const size_t b = std::min(C.start[i+1], a + delay);
+						Accumulator u = 0;
+						for (size_t l = a; l < b; ++l) u += xp[ci[l]];
+						s = _reduce(s - u, p);
+					}
+					scatter(i, 0, field().init(e, s));
+				}
+				else {
+					// the row of the k outputs, converted as soon as it is done
+					Accumulator *y = &Y[i*k];
+					std::fill(y, y + k, (Accumulator)0);
+					size_t since = 0;
+					for (size_t l = C.start[i]; l < C.start[i+1]; ++l) {
+						const Accumulator *x = xp + (size_t)ci[l]*k;
+						if (l < C.mid[i])
+							for (size_t c = 0; c < k; ++c) y[c] += x[c];
+						else
+							for (size_t c = 0; c < k; ++c) y[c] -= x[c];
+						if (++since == delay) {
+							for (size_t c = 0; c < k; ++c) y[c] = _reduce(y[c], p);
+							since = 0;
+						}
+					}
+					for (size_t c = 0; c < k; ++c)
+						scatter(i, c, field().init(e, _reduce(y[c], p)));
+				}
+			}
+			(void)t;
+		}
+
+		template<class Gather, class Scatter>
+		void _apply (const ZeroOneCSR& C, size_t, size_t k, Gather gather, Scatter scatter, std::false_type) const
+		{
+			const Field& F = field();
+			const size_t m = C.rowdim();
+			Element s;
+			for (size_t i = 0; i < m; ++i)
+				for (size_t c = 0; c < k; ++c) {
+					F.assign(s, F.zero);
+					for (size_t l = C.start[i]; l < C.mid[i]; ++l)
+						F.addin(s, gather(C.colid[l], c));
+					for (size_t l = C.mid[i]; l < C.start[i+1]; ++l)
+						F.subin(s, gather(C.colid[l], c));
+					scatter(i, c, s);
+				}
+		}
+	};
+
+	template<class Field>
+	struct is_blockbb<SignedZeroOne<Field> > {
+		static const bool value = true;
+	};
+
+}
+
+#endif // __LINBOX_signed_zero_one_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -46,6 +46,7 @@
 #include "linbox/vector/vector-domain.h"
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/apply-workspace.h"
 
 
 
@@ -116,8 +117,7 @@ namespace LinBox
 			   size_t          Rowdim,
 			   size_t          Coldim) :
 			_BB (BB),
-			_row (row), _col (col), _rowdim (Rowdim), _coldim (Coldim),
-			_z (_BB->coldim ()), _y (_BB->rowdim ())
+			_row (row), _col (col), _rowdim (Rowdim), _coldim (Coldim)
 		{
 			linbox_check (row + Rowdim <= _BB->rowdim ());
 			linbox_check (col + Coldim <= _BB->coldim ());
@@ -140,12 +140,16 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& apply (OutVector &y, const InVector& x) const
 		{
-			std::fill (_z.begin (), _z.begin () + (ptrdiff_t)_col, _BB->field().zero);
-			std::fill (_z.begin () + (ptrdiff_t)(_col + _coldim), _z.end (), _BB->field().zero);
-
-			copy (x.begin (), x.end (), _z.begin () + (ptrdiff_t)_col);  // Copying. Yuck.
-			_BB->apply (_y, _z);
-			copy (_y.begin () + (ptrdiff_t)_row, _y.begin () + (ptrdiff_t)(_row + _rowdim), y.begin ());
+			// vectors of the calling thread: the same submatrix can be applied by several threads
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& z = ws.template elements<Element> (0, _BB->coldim ());
+			std::vector<Element>& yy = ws.template elements<Element> (1, _BB->rowdim ());
+
+			std::fill (z.begin (), z.begin () + (ptrdiff_t)_col, _BB->field().zero);
+			std::fill (z.begin () + (ptrdiff_t)(_col + _coldim), z.end (), _BB->field().zero);
+			copy (x.begin (), x.end (), z.begin () + (ptrdiff_t)_col);  // Copying. Yuck.
+			_BB->apply (yy, z);
+			copy (yy.begin () + (ptrdiff_t)_row, yy.begin () + (ptrdiff_t)(_row + _rowdim), y.begin ());
 			return y;
 		}
 
@@ -161,12 +165,15 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& applyTranspose (OutVector &y, const InVector& x) const
 		{
-			std::fill (_y.begin (), _y.begin () + (ptrdiff_t)_row, _BB->field().zero);
-			std::fill (_y.begin () + (ptrdiff_t)(_row + _rowdim), _y.end (), _BB->field().zero);
-
-			copy (x.begin (), x.end (), _y.begin () + (ptrdiff_t)_row);  // Copying. Yuck.
-			_BB->applyTranspose (_z, _y);
-			copy (_z.begin () + (ptrdiff_t)_col, _z.begin () + (ptrdiff_t)(_col + _coldim), y.begin ());
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& yy = ws.template elements<Element> (1, _BB->rowdim ());
+			std::vector<Element>& z = ws.template elements<Element> (0, _BB->coldim ());
+
+			std::fill (yy.begin (), yy.begin () + (ptrdiff_t)_row, _BB->field().zero);
+			std::fill (yy.begin () + (ptrdiff_t)(_row + _rowdim), yy.end (), _BB->field().zero);
+			copy (x.begin (), x.end (), yy.begin () + (ptrdiff_t)_row);  // Copying. Yuck.
+			_BB->applyTranspose (z, yy);
+			copy (z.begin () + (ptrdiff_t)_col, z.begin () + (ptrdiff_t)(_col + _coldim), y.begin ());
 			return y;
 		}
 
@@ -229,10 +236,6 @@ namespace LinBox
 		size_t    _rowdim;
 		size_t    _coldim;
 
-		// Temporaries for reducing the amount of memory allocation we do
-		mutable std::vector<Element> _z;
-		mutable std::vector<Element> _y;
-
 	}; // template <Vector> class Submatrix
 
 
@@ -475,8 +478,7 @@ namespace LinBox
 				size_t          Rowdim,
 				size_t          Coldim) :
 			_BB_data (*BB),
-			_row (row), _col (col), _rowdim (Rowdim), _coldim (Coldim),
-			_z (_BB_data.coldim ()), _y (_BB_data.rowdim ())
+			_row (row), _col (col), _rowdim (Rowdim), _coldim (Coldim)
 		{
 			linbox_check (row + Rowdim <= _BB_data.rowdim ());
 			linbox_check (col + Coldim <= _BB_data.coldim ());
@@ -499,12 +501,16 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& apply (OutVector &y, const InVector& x) const
 		{
-			std::fill (_z.begin (), _z.begin () + (ptrdiff_t)_col, _BB_data.field().zero);
-			std::fill (_z.begin () + (ptrdiff_t)(_col + _coldim), _z.end (), _BB_data.field().zero);
-
-			copy (x.begin (), x.end (), _z.begin () +(ptrdiff_t) _col);  // Copying. Yuck.
-			_BB_data.apply (_y, _z);
-			copy (_y.begin () +(ptrdiff_t) _row, _y.begin () +(ptrdiff_t) (_row + _rowdim), y.begin ());
+			// vectors of the calling thread: the same submatrix can be applied by several threads
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& z = ws.template elements<Element> (0, _BB_data.coldim ());
+			std::vector<Element>& yy = ws.template elements<Element> (1, _BB_data.rowdim ());
+
+			std::fill (z.begin (), z.begin () + (ptrdiff_t)_col, _BB_data.field().zero);
+			std::fill (z.begin () + (ptrdiff_t)(_col + _coldim), z.end (), _BB_data.field().zero);
+			copy (x.begin (), x.end (), z.begin () + (ptrdiff_t)_col);  // Copying. Yuck.
+			_BB_data.apply (yy, z);
+			copy (yy.begin () + (ptrdiff_t)_row, yy.begin () + (ptrdiff_t)(_row + _rowdim), y.begin ());
 			return y;
 		}
 
@@ -520,12 +526,15 @@ namespace LinBox
 		template<class OutVector, class InVector>
 		OutVector& applyTranspose (OutVector &y, const InVector& x) const
 		{
-			std::fill (_y.begin (), _y.begin () +(ptrdiff_t) _row, _BB_data.field().zero);
-			std::fill (_y.begin () +(ptrdiff_t)( _row + _rowdim), _y.end (), _BB_data.field().zero);
-
-			copy (x.begin (), x.end (), _y.begin () + (ptrdiff_t)_row);  // Copying. Yuck.
-			_BB_data.applyTranspose (_z, _y);
-			copy (_z.begin () + (ptrdiff_t)_col, _z.begin () + (ptrdiff_t)(_col + _coldim), y.begin ());
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& yy = ws.template elements<Element> (1, _BB_data.rowdim ());
+			std::vector<Element>& z = ws.template elements<Element> (0, _BB_data.coldim ());
+
+			std::fill (yy.begin (), yy.begin () + (ptrdiff_t)_row, _BB_data.field().zero);
+			std::fill (yy.begin () + (ptrdiff_t)(_row + _rowdim), yy.end (), _BB_data.field().zero);
+			copy (x.begin (), x.end (), yy.begin () + (ptrdiff_t)_row);  // Copying. Yuck.
+			_BB_data.applyTranspose (z, yy);
+			copy (z.begin () + (ptrdiff_t)_col, z.begin () + (ptrdiff_t)(_col + _coldim), y.begin ());
 			return y;
 		}
 
@@ -546,8 +555,7 @@ namespace LinBox
 		SubmatrixOwner (const Submatrix<_BB, _Vc>& T, const Field& F) :
 			_BB_data(*(T.getPtr()), F),
 			_row(T.rowfirst()), _col(T.colfirst()),
-			_rowdim(T.rowdim()), _coldim(T.coldim()),
-			_z (_BB_data.coldim ()), _y (_BB_data.rowdim ())
+			_rowdim(T.rowdim()), _coldim(T.coldim())
 		{
 			typename Submatrix<_BB,_Vc>::template rebind<Field>()(*this,T );
 		}
@@ -555,8 +563,7 @@ namespace LinBox
 		SubmatrixOwner (const SubmatrixOwner<_BB,_Vc>& T, const Field& F) :
 			_BB_data(T.getData(), F),
 			_row(T.rowfirst()), _col(T.colfirst()),
-			_rowdim(T.rowdim()), _coldim(T.coldim()),
-			_z (_BB_data.coldim ()), _y (_BB_data.rowdim ())
+			_rowdim(T.rowdim()), _coldim(T.coldim())
 		{
 			typename SubmatrixOwner<_BB,_Vc>::template rebind<Field>()(*this,T);
 		}
@@ -612,10 +619,6 @@ namespace LinBox
 		size_t    _rowdim;
 		size_t    _coldim;
 
-		// Temporaries for reducing the amount of memory allocation we do
-		mutable std::vector<Element> _z;
-		mutable std::vector<Element> _y;
-
 	}; // template <Vector> class SubmatrixOwner
 
 
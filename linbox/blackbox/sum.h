@@ -32,6 +32,7 @@
 #include "linbox/vector/vector-domain.h"
 #include "linbox/util/debug.h"
 #include "linbox/blackbox/blackbox-interface.h"
+#include "linbox/blackbox/apply-workspace.h"
 
 namespace LinBox
 {
@@ -76,9 +77,6 @@ namespace LinBox
 		{
 			linbox_check (A.coldim () == B.coldim ());
 			linbox_check (A.rowdim () == B.rowdim ());
-
-			VectorWrapper::ensureDim (_z1, A.rowdim ());
-			VectorWrapper::ensureDim (_z2, A.coldim ());
 		}
 
 		/** Constructor from black box pointers.
@@ -94,9 +92,6 @@ namespace LinBox
 			linbox_check (B_ptr != 0);
 			linbox_check (A_ptr->coldim () == B_ptr->coldim ());
 			linbox_check (A_ptr->rowdim () == B_ptr->rowdim ());
-
-			VectorWrapper::ensureDim (_z1, A_ptr->rowdim ());
-			VectorWrapper::ensureDim (_z2, A_ptr->coldim ());
 		}
 
 		/** Copy constructor.
@@ -106,8 +101,6 @@ namespace LinBox
 		Sum (const Sum<Blackbox1, Blackbox2> &M) :
 			_A_ptr (M._A_ptr), _B_ptr (M._B_ptr), VD(M.VD)
 		{
-			VectorWrapper::ensureDim (_z1, _A_ptr->rowdim ());
-			VectorWrapper::ensureDim (_z2, _A_ptr->coldim ());
 		}
 
 		/// Destructor
@@ -128,8 +121,10 @@ namespace LinBox
 		inline OutVector &apply (OutVector &y, const InVector &x) const
 		{
 			_A_ptr->apply (y, x);
-			_B_ptr->apply (_z1, x);
-			VD.addin (y, _z1);
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& z1 = ws.template elements<Element> (0, rowdim ());
+			_B_ptr->apply (z1, x);
+			VD.addin (y, z1);
 
 			return y;
 		}
@@ -147,8 +142,10 @@ namespace LinBox
 		inline OutVector &applyTranspose (OutVector &y, const InVector &x) const
 		{
 			_A_ptr->applyTranspose (y, x);
-			_B_ptr->applyTranspose (_z2, x);
-			VD.addin (y, _z2);
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& z2 = ws.template elements<Element> (0, coldim ());
+			_B_ptr->applyTranspose (z2, x);
+			VD.addin (y, z2);
 
 			return y;
 		}
@@ -201,9 +198,6 @@ namespace LinBox
 		const Blackbox1       *_A_ptr;
 		const Blackbox2       *_B_ptr;
 
-		mutable std::vector<Element>  _z1;
-		mutable std::vector<Element>  _z2;
-
 		VectorDomain<Field> VD;
 	}; // template <Field, Vector> class Sum
 
@@ -241,9 +235,6 @@ namespace LinBox
 		{
 			linbox_check (A.coldim () == B.coldim ());
 			linbox_check (A.rowdim () == B.rowdim ());
-
-			VectorWrapper::ensureDim (_z1, A.rowdim ());
-			VectorWrapper::ensureDim (_z2, A.coldim ());
 		}
 
 		/** Constructor from black box pointers.
@@ -259,9 +250,6 @@ namespace LinBox
 			linbox_check (B_data != 0);
 			linbox_check (A_data->coldim () == B_data->coldim ());
 			linbox_check (A_data->rowdim () == B_data->rowdim ());
-
-			VectorWrapper::ensureDim (_z1, A_data->rowdim ());
-			VectorWrapper::ensureDim (_z2, A_data->coldim ());
 		}
 
 		/** Copy constructor.
@@ -271,8 +259,6 @@ namespace LinBox
 		SumOwner (const SumOwner<Blackbox1, Blackbox2> &M) :
 			_A_data (M._A_data), _B_data (M._B_data), VD(M.VD)
 		{
-			VectorWrapper::ensureDim (_z1, _A_data.rowdim ());
-			VectorWrapper::ensureDim (_z2, _A_data.coldim ());
 		}
 
 		/// Destructor
@@ -293,8 +279,10 @@ namespace LinBox
 		inline OutVector &apply (OutVector &y, const InVector &x) const
 		{
 			_A_data.apply (y, x);
-			_B_data.apply (_z1, x);
-			VD.addin (y, _z1);
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& z1 = ws.template elements<Element> (0, rowdim ());
+			_B_data.apply (z1, x);
+			VD.addin (y, z1);
 			return y;
 		}
 
@@ -311,8 +299,10 @@ namespace LinBox
 		inline OutVector &applyTranspose (OutVector &y, const InVector &x) const
 		{
 			_A_data.applyTranspose (y, x);
-			_B_data.applyTranspose (_z2, x);
-			VD.addin (y, _z2);
+			ApplyWorkspace<Self_t> ws;
+			std::vector<Element>& z2 = ws.template elements<Element> (0, coldim ());
+			_B_data.applyTranspose (z2, x);
+			VD.addin (y, z2);
 
 			return y;
 		}
@@ -333,8 +323,6 @@ namespace LinBox
 		SumOwner (const Sum<_BBt1, _BBt2> &M, const Field& F) :
 			_A_data(*(M.getLeftPtr()), F),
 			_B_data(*(M.getRightPtr()), F),
-			_z1(_A_data.rowdim()),
-			_z2(_A_data.coldim()),
 			VD(F)
 		{
 			typename Sum<_BBt1, _BBt2>::template rebind<Field>()(*this,M);
@@ -344,8 +332,6 @@ namespace LinBox
 		SumOwner (const SumOwner<_BBt1, _BBt2> &M, const Field& F) :
 			_A_data(M.getLeftData(), F),
 			_B_data(M.getRightData(), F) ,
-			_z1(_A_data.rowdim()),
-			_z2(_A_data.coldim()) ,
 			VD(F)
 		{
 			typename SumOwner<_BBt1, _BBt2>::template rebind<Field>()(*this,M);
@@ -410,9 +396,6 @@ namespace LinBox
 		Blackbox1       _A_data;
 		Blackbox2       _B_data;
 
-		mutable std::vector<Element>  _z1;
-		mutable std::vector<Element>  _z2;
-
 		VectorDomain<Field> VD;
 	}; // template <Field, Vector> class SumOwner
 
@@ -42,6 +42,8 @@
 #include "linbox/field/field-documentation.h"
 #include "linbox/field/field-traits.h"
 #include "linbox/util/field-axpy.h"
+#include "fflas-ffpack/fflas/fflas_simd.h"
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -63,6 +65,15 @@ namespace LinBox
 		typedef RingCategories::ModularTag categoryTag;
 	};
 
+	/** \brief Product of prime fields \f$\mathbb{Z}/p_1 \times \dots \times \mathbb{Z}/p_k\f$, in residue number system.
+	 *
+	 * An element is the contiguous array of its \c k residues, the \c l -th
+	 * in \f$[0,p_l)\f$, and the moduli and their inverses are kept in
+	 * arrays of the same layout: the arithmetic processes the \c k
+	 * residues at once, with SIMD instructions when available. Reductions
+	 * use the precomputed \f$1/p_l\f$ instead of a division. Conversions
+	 * to and from integers go through the product tree of the moduli.
+	 */
 	class MultiModDouble : public FieldDocumentation {
 
 	protected:
@@ -72,6 +83,10 @@ namespace LinBox
 		std::vector<integer>                 _crt_constant;
 		std::vector<double >                  _crt_inverse;
 		integer                                _crt_modulo;
+		std::vector<double>                       _moduli;
+		std::vector<double>                    _invModuli; // 1/p_l
+		size_t                                      _delay;
+		std::vector<std::vector<integer> >            _tree; // products of the moduli, _tree[0] are the moduli
 
 
 	public:
@@ -84,25 +99,16 @@ namespace LinBox
 		typedef MultiModRandIter                RandIter;
 
 		MultiModDouble () :
-		       	_size(0)
+		       	_size(0), _delay(0)
 		{}
 
 		MultiModDouble (const std::vector<integer> &primes) :
 			_fields(primes.size()), _size(primes.size()),
 			_crt_constant(primes.size()), _crt_inverse(primes.size())
 		{
-			_crt_modulo=1;
-			for (size_t i=0; i<_size; ++i){
+			for (size_t i=0; i<_size; ++i)
 				_fields[i] = ( Givaro::Modular<double> (primes[i]) );
-				_crt_modulo *= primes[i];
-			}
-			double tmp;
-			for (size_t i=0; i<_size; ++i){
-				_crt_constant[i]= _crt_modulo/(integer)primes[i];
-				_fields[i].init(tmp, _crt_constant[i]);
-				_fields[i].inv(_crt_inverse[i],tmp);
-			}
-
+			initialise();
 		}
 
 
@@ -110,24 +116,17 @@ namespace LinBox
 			_fields(primes.size()), _size(primes.size()),
 			_crt_constant(primes.size()), _crt_inverse(primes.size())
 		{
-			_crt_modulo=1;
-			for (size_t i=0; i<_size; ++i){
+			for (size_t i=0; i<_size; ++i)
 				_fields[i] = ( Givaro::Modular<double> (primes[i]) );
-				_crt_modulo *= primes[i];
-			}
-			double tmp;
-			for (size_t i=0; i<_size; ++i){
-				_crt_constant[i]= _crt_modulo/(integer)primes[i];
-				_fields[i].init(tmp, _crt_constant[i]);
-				_fields[i].inv(_crt_inverse[i],tmp);
-			}
+			initialise();
 		}
 
 
 		MultiModDouble(const MultiModDouble& F) :
 			_fields(F._fields), _size(F._size),
 			_crt_constant(F._crt_constant), _crt_inverse(F._crt_inverse),
-			_crt_modulo(F._crt_modulo) {}
+			_crt_modulo(F._crt_modulo), _moduli(F._moduli), _invModuli(F._invModuli),
+			_delay(F._delay), _tree(F._tree) {}
 
 		MultiModDouble &operator=(const MultiModDouble &F)
 		{
@@ -136,6 +135,10 @@ namespace LinBox
 			_crt_constant = F._crt_constant;
 			_crt_modulo   = F._crt_modulo;
 			_crt_inverse  = F._crt_inverse;
+			_moduli       = F._moduli;
+			_invModuli    = F._invModuli;
+			_delay        = F._delay;
+			_tree         = F._tree;
 			return *this;
 		}
 
@@ -155,11 +158,7 @@ namespace LinBox
 
 		integer &cardinality (integer &c) const
 		{
-			c=1;
-			for (size_t i=0; i<_size; ++i){
-				c*=getModulo(i);
-			}
-			return c;
+			return c=_crt_modulo;
 		}
 
 		integer &characteristic (integer &c) const
@@ -167,17 +166,68 @@ namespace LinBox
 			return c=integer(0);
 		}
 
+		/** \brief Number of products of two residues that can be added to a residue before reduce().
+		 *
+		 * Sums of products of residues are exact in \c double, reduce()
+		 * is exact while their absolute value is at most \f$2^{53}-2\max p_l\f$.
+		 */
+		size_t delayBound () const
+		{ return _delay; }
+
+		/** \brief Reduces \p x[l] modulo \f$p_l\f$, in \f$[0,p_l)\f$, for the size() values at \p x.
+		 *
+		 * The values are integers of absolute value at most
+		 * \f$2^{53}-2\max p_l\f$, such as delayBound() accumulated products.
+		 */
+		double* reduce (double *x) const
+		{
+			size_t l=0;
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+			for (; l+simd::vect_size<=_size; l+=simd::vect_size)
+				simd::storeu(x+l, reduce(simd::loadu(x+l), l));
+#endif
+			for (; l<_size; ++l)
+				x[l] = reduce(x[l], l);
+			return x;
+		}
+
+		//! CRT reconstruction in \f$[0,\prod p_l)\f$, summed up the product tree.
 		integer &convert (integer &x, const Element &y) const
 		{
-			x=0;
+			if (_size == 0)
+				return x=0;
+
+			// v_l = y_l (M/p_l)^{-1} mod p_l, then x = sum v_l M/p_l
+			std::vector<integer> v(_size);
 			double tmp;
 			for (size_t i=0;i<_size; ++i){
 				_fields[i].mul(tmp, y[i], _crt_inverse[i]);
-				integer res= tmp;
-				x= x + ( res*_crt_constant[i]);
-				if (x > _crt_modulo)
-					x-= _crt_modulo;
+				v[i] = tmp;
 			}
+			for (size_t h=0; h+1<_tree.size(); ++h) {
+				const std::vector<integer>& T = _tree[h];
+				for (size_t j=0; 2*j<T.size(); ++j) {
+					if (2*j+1 < T.size()) {
+						integer t = v[2*j+1]*T[2*j];
+						v[j] = v[2*j]*T[2*j+1];
+						v[j] += t;
+					}
+					else
+						v[j] = v[2*j];
+				}
+				v.resize((T.size()+1)/2);
+			}
+			x = v[0];
+			x %= _crt_modulo;
+			return x;
+		}
+
+		//! CRT reconstruction of each element of \p y.
+		std::vector<integer> &convert (std::vector<integer> &x, const std::vector<Element> &y) const
+		{
+			x.resize(y.size());
+			for (size_t i=0; i<y.size(); ++i)
+				convert(x[i], y[i]);
 			return x;
 		}
 
@@ -226,10 +276,36 @@ namespace LinBox
 		}
 
 
+		//! Residues of \p y, down the product tree when it is larger than the moduli.
 		Element &init (Element &x, const integer &y) const  {
 			x.resize(_size);
+			if (y.bitsize() <= 52) {
+				std::fill(x.begin(), x.end(), (double)y);
+				reduce(x.data());
+				return x;
+			}
+
+			std::vector<integer> r(1, y % _crt_modulo), s;
+			if (r[0] < 0)
+				r[0] += _crt_modulo;
+			for (size_t h=_tree.size()-1; h-- > 0; ) {
+				const std::vector<integer>& T = _tree[h];
+				s.resize(T.size());
+				for (size_t i=0; i<T.size(); ++i)
+					s[i] = r[i/2] % T[i];
+				r.swap(s);
+			}
 			for (size_t i=0;i<_size; ++i)
-				_fields[i].init(x[i], y);
+				x[i] = (double)r[i];
+			return x;
+		}
+
+		//! Residues of each integer of \p y.
+		std::vector<Element> &init (std::vector<Element> &x, const std::vector<integer> &y) const
+		{
+			x.resize(y.size());
+			for (size_t i=0; i<y.size(); ++i)
+				init(x[i], y[i]);
 			return x;
 		}
 
@@ -256,40 +332,60 @@ namespace LinBox
 
 		inline  bool isZero (const Element &x) const
 		{
-			return x == std::vector<double> (_size, 0.);
+			for (size_t i=0;i<_size;++i)
+				if (x[i] != 0.) return false;
+			return true;
 		}
 
 		inline bool isOne (const Element &x) const
 		{
-			return x == std::vector<double>(_size, 1.);
+			for (size_t i=0;i<_size;++i)
+				if (x[i] != 1.) return false;
+			return true;
 		}
 
 		inline bool isMOne (const Element &x) const
 		{
-			return x == std::vector<double>(_size, -1.); // bug
+			for (size_t i=0;i<_size;++i)
+				if (x[i] != _moduli[i]-1.) return false;
+			return true;
 		}
 
 		inline Element &add (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i) {
-				_fields[i].add(x[i], y[i], z[i]);
+			size_t l=0;
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+			for (; l+simd::vect_size<=_size; l+=simd::vect_size) {
+				vect_t v = simd::add(simd::loadu(&y[l]), simd::loadu(&z[l]));
+				simd::storeu(&x[l], correct(simd::sub(v, simd::loadu(&_moduli[l])), l));
 			}
+#endif
+			for (; l<_size; ++l)
+				x[l] = correct(y[l] + z[l] - _moduli[l], l);
 			return x;
 		}
 
 		inline Element &sub (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].sub(x[i], y[i], z[i]);
-			}
+			size_t l=0;
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+			for (; l+simd::vect_size<=_size; l+=simd::vect_size)
+				simd::storeu(&x[l], correct(simd::sub(simd::loadu(&y[l]), simd::loadu(&z[l])), l));
+#endif
+			for (; l<_size; ++l)
+				x[l] = correct(y[l] - z[l], l);
 			return x;
 		}
 
 		inline Element &mul (Element &x, const Element &y, const Element &z) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].mul(x[i], y[i], z[i]);
-			}
+			size_t l=0;
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+			for (; l+simd::vect_size<=_size; l+=simd::vect_size)
+				simd::storeu(&x[l], reduce(simd::mul(simd::loadu(&y[l]), simd::loadu(&z[l])), l));
+#endif
+			for (; l<_size; ++l)
+				x[l] = reduce(y[l] * z[l], l);
 			return x;
 		}
 
@@ -303,9 +399,13 @@ namespace LinBox
 
 		inline Element &neg (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].neg(x[i], y[i]);
-			}
+			size_t l=0;
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+			for (; l+simd::vect_size<=_size; l+=simd::vect_size)
+				simd::storeu(&x[l], correct(simd::sub(simd::zero(), simd::loadu(&y[l])), l));
+#endif
+			for (; l<_size; ++l)
+				x[l] = correct(-y[l], l);
 			return x;
 		}
 
@@ -322,34 +422,31 @@ namespace LinBox
 				      const Element &x,
 				      const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].axpy(r[i], a[i], x[i], y[i]);
-			}				\
+			size_t l=0;
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+			for (; l+simd::vect_size<=_size; l+=simd::vect_size) {
+				vect_t v = simd::mul(simd::loadu(&a[l]), simd::loadu(&x[l]));
+				simd::storeu(&r[l], reduce(simd::add(v, simd::loadu(&y[l])), l));
+			}
+#endif
+			for (; l<_size; ++l)
+				r[l] = reduce(a[l] * x[l] + y[l], l);
 			return r;
 		}
 
 		inline Element &addin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].addin(x[i], y[i]);
-			}
-			return x;
+			return add(x, x, y);
 		}
 
 		inline Element &subin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].subin(x[i], y[i]);
-			}
-			return x;
+			return sub(x, x, y);
 		}
 
 		inline Element &mulin (Element &x, const Element &y) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].mulin(x[i], y[i]);
-			}
-			return x;
+			return mul(x, x, y);
 		}
 
 		inline Element &divin (Element &x, const Element &y) const
@@ -362,10 +459,7 @@ namespace LinBox
 
 		inline Element &negin (Element &x) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].negin(x[i]);
-			}
-			return x;
+			return neg(x, x);
 		}
 
 		inline Element &invin (Element &x) const
@@ -378,15 +472,80 @@ namespace LinBox
 
 		inline Element &axpyin (Element &r, const Element &a, const Element &x) const
 		{
-			for (size_t i=0;i<_size;++i){
-				_fields[i].axpyin(r[i], a[i], x[i]);
-			}
-			return r;
+			return axpy(r, a, x, r);
 		}
 
 		static inline double maxCardinality()
 		{ return 94906265.0; } // floor( 2^26.5 )
 
+	protected:
+
+		void initialise ()
+		{
+			_moduli.resize(_size);
+			_invModuli.resize(_size);
+			double pmax = 1.;
+			for (size_t i=0; i<_size; ++i){
+				_moduli[i] = _fields[i].fcharacteristic();
+				_invModuli[i] = 1./_moduli[i];
+				pmax = std::max(pmax, _moduli[i]);
+			}
+			// 2^53 - 2 pmax, see reduce()
+			_delay = (_size == 0) ? 0 :
+				(size_t)std::floor((9007199254740992. - 2.*pmax) / ((pmax-1.)*(pmax-1.)));
+
+			_tree.assign(1, std::vector<integer>(_size));
+			for (size_t i=0; i<_size; ++i)
+				_tree[0][i] = integer(getModulo(i));
+			while (_tree.back().size() > 1) {
+				const std::vector<integer>& T = _tree.back();
+				std::vector<integer> U((T.size()+1)/2);
+				for (size_t j=0; j<U.size(); ++j)
+					U[j] = (2*j+1 < T.size()) ? T[2*j]*T[2*j+1] : T[2*j];
+				_tree.push_back(U);
+			}
+			_crt_modulo = (_size == 0) ? integer(1) : _tree.back()[0];
+
+			double tmp;
+			for (size_t i=0; i<_size; ++i){
+				_crt_constant[i]= _crt_modulo/_tree[0][i];
+				_fields[i].init(tmp, _crt_constant[i]);
+				_fields[i].inv(_crt_inverse[i],tmp);
+			}
+		}
+
+		// x - q p_l, q = floor(x/p_l), is exact and in (-p_l,2p_l) for |x| <= 2^53 - 2p_l
+		double reduce (double x, size_t l) const
+		{
+			x -= std::floor(x * _invModuli[l]) * _moduli[l];
+			return correct(correct(x, l) - _moduli[l], l);
+		}
+
+		// x + p_l if x < 0
+		double correct (double x, size_t l) const
+		{
+			return (x < 0.) ? x + _moduli[l] : x;
+		}
+
+#ifdef __FFLASFFPACK_HAVE_SSE4_1_INSTRUCTIONS
+		typedef Simd<double>         simd;
+		typedef simd::vect_t       vect_t;
+
+		// lanes l, l+1, ... of the above
+		vect_t reduce (vect_t x, size_t l) const
+		{
+			vect_t P = simd::loadu(&_moduli[l]);
+			vect_t Q = simd::floor(simd::mul(x, simd::loadu(&_invModuli[l])));
+			x = simd::fnmadd(x, Q, P);
+			return correct(simd::sub(correct(x, l), P), l);
+		}
+
+		vect_t correct (vect_t x, size_t l) const
+		{
+			return simd::add(x, simd::vand(simd::lesser(x, simd::zero()), simd::loadu(&_moduli[l])));
+		}
+#endif
+
 	};// end of class MultiModField
 
 	class MultiModRandIter {
@@ -435,88 +594,140 @@ namespace LinBox
 
 	}; // end of class MultiModRandIter
 
-#if 0
+	/** \brief Accumulator over a MultiModDouble.
+	 *
+	 * The products are added without reduction, delayBound() at a time.
+	 */
 	template <>
-	class DotProductDomain<MultiModDouble > : private  VectorDomainBase<MultiModDouble> {
-	private:
-		//std::vector<double> _bound;
-		std::vector<size_t>  _nmax;
-		//double _invmod;
-
+	class FieldAXPY<MultiModDouble> {
 	public:
-		typedef std::vector<double> Element;
+		typedef MultiModDouble           Field;
+		typedef Field::Element         Element;
+		typedef Element                Abnormal;
 
-		DotProductDomain (const MultiModDouble &F) :
-			VectorDomainBase<MultiModDouble > (F) //, _invmod(1./_field.modulus)
+		FieldAXPY (const Field &F) :
+			_field(&F), _y(F.size(), 0.), _pending(0)
+		{}
+
+		FieldAXPY (const FieldAXPY &faxpy) :
+			_field(faxpy._field), _y(faxpy._y), _pending(faxpy._pending)
+		{}
+
+		FieldAXPY &operator = (const FieldAXPY &faxpy)
+		{
+			_field   = faxpy._field;
+			_y       = faxpy._y;
+			_pending = faxpy._pending;
+			return *this;
+		}
+
+		inline Element& mulacc (const Element &a, const Element &x)
 		{
-			for (size_t i=0; i<F.size();++i){
-				//_bound[i]=  (double) (1<<53 - (int) (_field.getModulo(i)*_field.getModulo(i))))
-				_nmax[i] =  (size_t)floor((double(1<<26)* double(1<<26)*2.)/ (_field.getModulo(i) * _field.getModulo(i)));
+			for (size_t l=0; l<_y.size(); ++l)
+				_y[l] += a[l] * x[l];
+			return pending();
+		}
+
+		inline Element& accumulate (const Element &t)
+		{
+			for (size_t l=0; l<_y.size(); ++l)
+				_y[l] += t[l];
+			return pending();
+		}
+
+		inline Element& get (Element &y)
+		{
+			field().reduce(_y.data());
+			_pending = 0;
+			return y = _y;
+		}
+
+		inline FieldAXPY &assign (const Element &y)
+		{
+			_y = y;
+			_pending = 0;
+			return *this;
+		}
+
+		inline void reset()
+		{
+			std::fill(_y.begin(), _y.end(), 0.);
+			_pending = 0;
+		}
+
+		inline const Field& field() const { return *_field; }
+
+	protected:
+		const Field *_field;
+		Element          _y;
+		size_t     _pending;
+
+		Element& pending ()
+		{
+			if (++_pending == field().delayBound()) {
+				field().reduce(_y.data());
+				_pending = 0;
 			}
+			return _y;
 		}
+	};
+
+	/** \brief Dot products over a MultiModDouble.
+	 *
+	 * The products of all the residues are accumulated together, and
+	 * reduced every delayBound() terms.
+	 */
+	template <>
+	class DotProductDomain<MultiModDouble> : public VectorDomainBase<MultiModDouble> {
+	public:
+		typedef MultiModDouble::Element Element;
+
+		DotProductDomain (const MultiModDouble &F) :
+			VectorDomainBase<MultiModDouble> (F)
+		{}
+
+		using VectorDomainBase<MultiModDouble>::field;
+		using VectorDomainBase<MultiModDouble>::init;
 
 	protected:
 		template <class Vector1, class Vector2>
 		inline Element &dotSpecializedDD (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
-
-			for (size_t k=0;k<_field.size();++k){
-				double y = 0.;
-				double t = 0.;
-				if (v1.size() < _nmax[k]) {
-					for (size_t i = 0; i< v1.size();++i)
-						y += v1[i][k] * v2[i][k] ;
-					y = fmod(y, _field.getModulo(k));
-				}
-				else{
-					size_t i=0;
-					for (;i< v1.size()- _nmax[k] ;i=i+_nmax[k]){
-						for (size_t j=i;j<i+_nmax[k];++j)
-							y += v1[j][k] * v2[j][k];
-						t+=fmod(y, _field.getModulo(k));
-						y=0.;
-					}
-					for (;i < v1.size();++i)
-						y += v1[i][k] * v2[i][k];
-					t+=fmod(y, _field.getModulo(k));
-					y = fmod(t, _field.getModulo(k));
+			const size_t k = field().size(), delay = field().delayBound();
+			res.assign(k, 0.);
+			size_t pending = 0;
+			for (size_t i = 0; i < v1.size(); ++i) {
+				const double *a = &v1[i][0], *b = &v2[i][0];
+				for (size_t l = 0; l < k; ++l)
+					res[l] += a[l] * b[l];
+				if (++pending == delay) {
+					field().reduce(res.data());
+					pending = 0;
 				}
-				res[k]=y;
 			}
+			field().reduce(res.data());
 			return res;
 		}
 
 		template <class Vector1, class Vector2>
 		inline Element &dotSpecializedDSP (Element &res, const Vector1 &v1, const Vector2 &v2) const
 		{
-
-			for (size_t k=0;k<_field.size();++k){
-				double y = 0.;
-				double t =0.;
-
-				if (v1.first.size() < _nmax[k]) {
-					for (size_t i=0;i<v1.first.size();++i)
-						y+= v1.second[i] * v2[v1.first[i]];
-					y = fmod(y, _field.getModulo(k));
-				}
-				else {
-					size_t i=0;
-					for (;i< v1.first.size()- _nmax[k] ;i=i+_nmax[k]){
-						for (size_t j=i;j<i+_nmax[k];++j)
-							y += v1.second[j] * v2[v1.first[j]];
-						t+=fmod(y, _field.getModulo(k));
-						y=0.;
-					}
-					for (;i < v1.first.size();++i)
-						y += v1.second[i] * v2[v1.first[i]];
-					t+= fmod(y, _field.getModulo(k));
-					y = fmod(t, _field.getModulo(k));
+			const size_t k = field().size(), delay = field().delayBound();
+			res.assign(k, 0.);
+			size_t pending = 0;
+			for (size_t i = 0; i < v1.first.size(); ++i) {
+				const double *a = &v1.second[i][0], *b = &v2[v1.first[i]][0];
+				for (size_t l = 0; l < k; ++l)
+					res[l] += a[l] * b[l];
+				if (++pending == delay) {
+					field().reduce(res.data());
+					pending = 0;
 				}
 			}
+			field().reduce(res.data());
 			return res;
 		}
 	};
-#endif
 
 }
 
@@ -734,10 +734,13 @@ namespace LinBox
 		template <class Vector1, class Vector2>
 		Vector1&  applyTranspose (Vector1& y, const Vector2& x) const ;
 
-		subMatrixType& applyRight(subMatrixType& Y, const subMatrixType& X)
-		{ return Y; } // temp
-		subMatrixType& applyLeft(subMatrixType& Y, const subMatrixType& X)
-		{ return Y; } // temp
+		/// Y = X*A, several vectors at once (rows of X).
+		template <class Matrix1, class Matrix2>
+		Matrix1& applyRight(Matrix1& Y, const Matrix2& X) const ;
+
+		/// Y = A*X, several vectors at once (columns of X).
+		template <class Matrix1, class Matrix2>
+		Matrix1& applyLeft(Matrix1& Y, const Matrix2& X) const ;
 
 		const _Field& field() const;
 		//_Field& field() ;
@@ -1531,6 +1531,20 @@ namespace LinBox
 		return y;
 	}
 
+	template < class _Field, class _Rep >
+	template <class Matrix1, class Matrix2>
+	Matrix1&  BlasMatrix< _Field, _Rep >::applyLeft (Matrix1& Y, const Matrix2& X) const
+	{
+		return _MD.mul(Y, *this, X);
+	}
+
+	template < class _Field, class _Rep >
+	template <class Matrix1, class Matrix2>
+	Matrix1&  BlasMatrix< _Field, _Rep >::applyRight (Matrix1& Y, const Matrix2& X) const
+	{
+		return _MD.mul(Y, X, *this);
+	}
+
 	template < class _Field, class _Rep >
 	const _Field& BlasMatrix< _Field, _Rep >::field() const
 	{
@@ -36,6 +36,7 @@
 #include "linbox/matrix/densematrix/blas-matrix.h"
 
 #include "linbox/matrix/permutation-matrix.h"
+#include "linbox/matrix/matrixdomain/blas-parallelism.h"
 
 namespace LinBox
 {
@@ -92,6 +93,10 @@ namespace LinBox
 		template<class _Rep>
 		PLUQMatrix (BlasMatrix<Field,_Rep>& A) ;
 
+		//! Contruction of PLUQ factorization of A (making a copy of A), on the threads of \p par
+		template<class _Rep>
+		PLUQMatrix (const BlasMatrix<Field,_Rep>& A, const BlasParallelism& par) ;
+
 
 		/*! Contruction of PLUQ factorization of A (making a copy of A).
 		 * P and Q are arguments !
@@ -1083,6 +1083,34 @@ namespace LinBox
 		}
 	}
 
+	template <class Field>
+	template <class _Rep>
+	PLUQMatrix<Field>::PLUQMatrix (const BlasMatrix<Field,_Rep>& A, const BlasParallelism& par) :
+		_field(A.field()), _factLU(*(new BlasMatrix<Field,_Rep> (A))) ,
+		_permP(*(new BlasPermutation<size_t>(A.rowdim()))),
+		_permQ(*(new BlasPermutation<size_t>(A.coldim()))),
+		_m(A.rowdim()), _n(A.coldim()),
+		_alloc(true),_plloc(true)
+	{
+		size_t t = par.effective();
+		if (!A.coldim() || !A.rowdim()) {
+			_rank = 0 ;
+		}
+		else if (t > 1) {
+			BlasParallelism::run(t, [&]() {
+				_rank= FFPACK::PLUQ (_field, FFLAS::FflasNonUnit, _m, _n,
+						     _factLU.getPointer(),_factLU.getStride(),
+						     _permP.getWritePointer(), _permQ.getWritePointer(),
+						     BlasParallelism::PLUQHelper(t));
+			});
+		}
+		else {
+			_rank= FFPACK::PLUQ (_field, FFLAS::FflasNonUnit, _m, _n,
+					     _factLU.getPointer(),_factLU.getStride(),
+					     _permP.getWritePointer(), _permQ.getWritePointer());
+		}
+	}
+
 	template <class Field>
 	template <class _Rep>
 	PLUQMatrix<Field>::PLUQMatrix (const BlasMatrix<Field,_Rep>& A,
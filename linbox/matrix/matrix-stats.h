@@ -0,0 +1,423 @@
+/* linbox/matrix/matrix-stats.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/matrix-stats.h
+ * @ingroup matrix
+ * @brief Statistics of the nonzero entries of a matrix.
+ *
+ * One pass over the entries gives the nonzeros of each row and column,
+ * the bandwidth, the largest absolute value of an entry, the number of
+ * entries equal to 1 and -1, and the diagonal blocks the matrix splits
+ * into after permutation. The rows are shared between threads when the
+ * storage gives access to a row, which is the case of BlasMatrix and of
+ * the row-wise and CSR SparseMatrix formats.
+ *
+ * The matrices do not keep their statistics: \c matrixStats computes them
+ * on each call, and a caller needing them repeatedly keeps the result, or
+ * a MatrixStatsCache it clears when it modifies the matrix.
+ */
+
+#ifndef __LINBOX_matrix_stats_H
+#define __LINBOX_matrix_stats_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "linbox/integer.h"
+#include "linbox/matrix/sparse-formats.h"
+
+#ifndef LINBOX_MATRIX_STATS_GRAIN
+// fewest rows handled by a thread
+#define LINBOX_MATRIX_STATS_GRAIN 256
+#endif
+
+namespace LinBox
+{
+
+	template <class _Field, class _Rep>
+	class BlasMatrix;
+	template <class _Matrix>
+	class BlasSubmatrix;
+	template <class _Field, class _Storage>
+	class SparseMatrix;
+
+	/** \brief Statistics of the nonzero entries of a matrix.
+	 * \ingroup matrix
+	 */
+	struct MatrixStats {
+		size_t rowdim = 0;
+		size_t coldim = 0;
+		size_t nnz = 0;
+		std::vector<size_t> rowCount;      //!< nonzeros of each row
+		std::vector<size_t> colCount;      //!< nonzeros of each column
+		std::vector<size_t> rowHistogram;  //!< [0]: empty rows, [k]: rows with \f$2^{k-1}\f$ to \f$2^k-1\f$ nonzeros
+		std::vector<size_t> colHistogram;  //!< same for the columns
+		size_t maxRowCount = 0;
+		size_t maxColCount = 0;
+		size_t lowerBandwidth = 0;         //!< largest \f$i-j\f$ of a nonzero entry \f$(i,j)\f$
+		size_t upperBandwidth = 0;         //!< largest \f$j-i\f$ of a nonzero entry \f$(i,j)\f$
+		Integer maxNorm = 0;               //!< largest absolute value of an entry, as converted to an Integer by the field
+		bool negative = false;             //!< whether an entry converts to a negative Integer
+		size_t ones = 0;                   //!< entries equal to 1
+		size_t minusOnes = 0;              //!< entries equal to -1 (and not to 1)
+		size_t blocks = 0;                 //!< diagonal blocks, after permutation of the rows and columns
+		size_t largestBlockRows = 0;       //!< rows of the largest block
+		size_t largestBlockCols = 0;       //!< columns of the largest block
+
+		size_t maxBits () const { return maxNorm.bitsize(); }
+		double density () const { return (rowdim && coldim) ? (double)nnz / ((double)rowdim * (double)coldim) : 0.; }
+		bool zeroOne () const { return ones == nnz; }
+		bool plusMinusOne () const { return ones + minusOnes == nnz; }
+		size_t emptyRows () const { return rowHistogram.empty() ? rowdim : rowHistogram[0]; }
+		size_t emptyCols () const { return colHistogram.empty() ? coldim : colHistogram[0]; }
+
+		/// Statistics of \p A on \p threads threads, 0 for all the available ones.
+		template <class Matrix>
+		static MatrixStats analyse (const Matrix& A, size_t threads = 0);
+	};
+
+	/** \brief Statistics of a matrix, kept by the caller.
+	 * \ingroup matrix
+	 *
+	 * The matrix does not know about it: whoever owns the cache clears it
+	 * after modifying the matrix.
+	 */
+	class MatrixStatsCache {
+	public:
+		typedef std::shared_ptr<const MatrixStats> Pointer;
+
+		/// Statistics of \p A, computed on the first call after construction or clear().
+		template <class Matrix>
+		Pointer get (const Matrix& A, size_t threads = 0)
+		{
+			if (! _stats)
+				_stats = std::make_shared<const MatrixStats>(MatrixStats::analyse(A, threads));
+			return _stats;
+		}
+
+		void clear () { _stats.reset(); }
+
+	protected:
+		Pointer _stats;
+	};
+
+	/*! @internal Access to the entries of a matrix for MatrixStats.
+	 * \c row(A, i, f) calls \c f(j, a_ij) on the nonzero entries of row \c i
+	 * when \c rowAccess, \c all(A, f) calls \c f(i, j, a_ij) on all of them.
+	 */
+	template <class Matrix>
+	struct MatrixStatsEntries {
+		static const bool rowAccess = false;
+
+		template <class Function>
+		static void row (const Matrix&, size_t, Function) {}
+
+		template <class Function>
+		static void all (const Matrix& A, Function f)
+		{
+			for (auto it = A.IndexedBegin(); it != A.IndexedEnd(); ++it)
+				if (! A.field().isZero(it.value()))
+					f(it.rowIndex(), it.colIndex(), it.value());
+		}
+	};
+
+	template <class Matrix>
+	struct MatrixStatsDenseEntries {
+		static const bool rowAccess = true;
+
+		template <class Function>
+		static void row (const Matrix& A, size_t i, Function f)
+		{
+			for (size_t j = 0; j < A.coldim(); ++j) {
+				const auto& a = A.getEntry(i, j);
+				if (! A.field().isZero(a))
+					f(j, a);
+			}
+		}
+
+		template <class Function>
+		static void all (const Matrix&, Function) {}
+	};
+
+	template <class Field, class Rep>
+	struct MatrixStatsEntries<BlasMatrix<Field, Rep> > : public MatrixStatsDenseEntries<BlasMatrix<Field, Rep> > {};
+
+	template <class _Matrix>
+	struct MatrixStatsEntries<BlasSubmatrix<_Matrix> > : public MatrixStatsDenseEntries<BlasSubmatrix<_Matrix> > {};
+
+	template <class Field>
+	struct MatrixStatsEntries<SparseMatrix<Field, SparseMatrixFormat::SparseSeq> > {
+		static const bool rowAccess = true;
+
+		template <class Function>
+		static void row (const SparseMatrix<Field, SparseMatrixFormat::SparseSeq>& A, size_t i, Function f)
+		{
+			for (const auto& e : A[i])
+				if (! A.field().isZero(e.second))
+					f(e.first, e.second);
+		}
+
+		template <class Function>
+		static void all (const SparseMatrix<Field, SparseMatrixFormat::SparseSeq>&, Function) {}
+	};
+
+	template <class Field>
+	struct MatrixStatsEntries<SparseMatrix<Field, SparseMatrixFormat::SparseMap> > {
+		static const bool rowAccess = true;
+
+		template <class Function>
+		static void row (const SparseMatrix<Field, SparseMatrixFormat::SparseMap>& A, size_t i, Function f)
+		{
+			for (const auto& e : A[i])
+				if (! A.field().isZero(e.second))
+					f(e.first, e.second);
+		}
+
+		template <class Function>
+		static void all (const SparseMatrix<Field, SparseMatrixFormat::SparseMap>&, Function) {}
+	};
+
+	template <class Field>
+	struct MatrixStatsEntries<SparseMatrix<Field, SparseMatrixFormat::SparsePar> > {
+		static const bool rowAccess = true;
+
+		template <class Function>
+		static void row (const SparseMatrix<Field, SparseMatrixFormat::SparsePar>& A, size_t i, Function f)
+		{
+			const auto& r = A[i];
+			for (size_t k = 0; k < r.first.size(); ++k)
+				if (! A.field().isZero(r.second[k]))
+					f(r.first[k], r.second[k]);
+		}
+
+		template <class Function>
+		static void all (const SparseMatrix<Field, SparseMatrixFormat::SparsePar>&, Function) {}
+	};
+
+	template <class Field>
+	struct MatrixStatsEntries<SparseMatrix<Field, SparseMatrixFormat::CSR> > {
+		static const bool rowAccess = true;
+
+		template <class Function>
+		static void row (const SparseMatrix<Field, SparseMatrixFormat::CSR>& A, size_t i, Function f)
+		{
+			for (size_t k = (size_t)A.getStart(i); k < (size_t)A.getEnd(i); ++k)
+				if (! A.field().isZero(A.getData(k)))
+					f(A.getColid(k), A.getData(k));
+		}
+
+		template <class Function>
+		static void all (const SparseMatrix<Field, SparseMatrixFormat::CSR>&, Function) {}
+	};
+
+	/*! @internal Statistics of the entries seen by one thread. */
+	struct MatrixStatsPartial {
+		size_t nnz = 0, ones = 0, minusOnes = 0;
+		size_t lower = 0, upper = 0;
+		Integer maxNorm = 0, tmp = 0;
+		bool negative = false;
+
+		template <class Field>
+		void entry (const Field& F, size_t i, size_t j, const typename Field::Element& a)
+		{
+			++nnz;
+			if (i > j) lower = std::max(lower, i - j);
+			else upper = std::max(upper, j - i);
+			if (F.isOne(a)) ++ones;
+			else if (F.isMOne(a)) ++minusOnes;
+			F.convert(tmp, a);
+			if (tmp < 0) {
+				negative = true;
+				tmp = -tmp;
+			}
+			if (maxNorm < tmp) maxNorm = tmp;
+		}
+	};
+
+	/*! @internal Union-find forest shared by the threads.
+	 * A root is linked below a smaller index by a compare-and-swap, so that
+	 * parents only decrease and concurrent unions never make a cycle.
+	 */
+	struct MatrixStatsForest {
+		std::vector<std::atomic<size_t> > parent;
+
+		MatrixStatsForest (size_t size) :
+			parent(size)
+		{
+			for (size_t x = 0; x < size; ++x) parent[x].store(x, std::memory_order_relaxed);
+		}
+
+		size_t find (size_t x)
+		{
+			while (true) {
+				size_t p = parent[x].load();
+				if (p == x) return x;
+				size_t g = parent[p].load();
+				if (g != p) parent[x].compare_exchange_weak(p, g);
+				x = g;
+			}
+		}
+
+		void unite (size_t x, size_t y)
+		{
+			while (true) {
+				x = find(x); y = find(y);
+				if (x == y) return;
+				if (x < y) std::swap(x, y);
+				size_t root = x;
+				if (parent[x].compare_exchange_strong(root, y)) return;
+			}
+		}
+	};
+
+	template <class Matrix>
+	MatrixStats MatrixStats::analyse (const Matrix& A, size_t threads)
+	{
+		typedef MatrixStatsEntries<Matrix> Entries;
+		const size_t m = A.rowdim(), n = A.coldim();
+
+		size_t t = 1;
+#ifdef _OPENMP
+		if (Entries::rowAccess) {
+			t = threads ? threads : (size_t)omp_get_max_threads();
+			t = std::max((size_t)1, std::min(t, m / LINBOX_MATRIX_STATS_GRAIN));
+		}
+#endif
+		(void)threads;
+
+		MatrixStats S;
+		S.rowdim = m;
+		S.coldim = n;
+		S.rowCount.assign(m, 0);
+		S.colCount.assign(n, 0);
+		// the threads share the column counts and the forest on the rows then the columns
+		std::vector<MatrixStatsPartial> part(t);
+		MatrixStatsForest forest(m + n);
+
+		if (Entries::rowAccess) {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads((int)t) schedule(dynamic, LINBOX_MATRIX_STATS_GRAIN)
+#endif
+			for (long i = 0; i < (long)m; ++i) {
+#ifdef _OPENMP
+				MatrixStatsPartial& P = part[(size_t)omp_get_thread_num()];
+#else
+				MatrixStatsPartial& P = part[0];
+#endif
+				size_t before = P.nnz;
+				Entries::row(A, (size_t)i, [&](size_t j, const typename Matrix::Field::Element& a) {
+					P.entry(A.field(), (size_t)i, j, a);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+					++S.colCount[j];
+					forest.unite((size_t)i, m + j);
+				});
+				S.rowCount[(size_t)i] = P.nnz - before;
+			}
+		}
+		else {
+			MatrixStatsPartial& P = part[0];
+			Entries::all(A, [&](size_t i, size_t j, const typename Matrix::Field::Element& a) {
+				P.entry(A.field(), i, j, a);
+				++S.rowCount[i];
+				++S.colCount[j];
+				forest.unite(i, m + j);
+			});
+		}
+
+		// merge the partial statistics into the first one
+		MatrixStatsPartial& G = part[0];
+		for (size_t p = 1; p < t; ++p) {
+			const MatrixStatsPartial& P = part[p];
+			G.nnz += P.nnz;
+			G.ones += P.ones;
+			G.minusOnes += P.minusOnes;
+			G.lower = std::max(G.lower, P.lower);
+			G.upper = std::max(G.upper, P.upper);
+			G.negative = G.negative || P.negative;
+			if (G.maxNorm < P.maxNorm) G.maxNorm = P.maxNorm;
+		}
+		S.nnz = G.nnz;
+		S.ones = G.ones;
+		S.minusOnes = G.minusOnes;
+		S.lowerBandwidth = G.lower;
+		S.upperBandwidth = G.upper;
+		S.negative = G.negative;
+		S.maxNorm = G.maxNorm;
+
+		auto histogram = [](const std::vector<size_t>& count, std::vector<size_t>& h, size_t& mx) {
+			h.assign(1, 0);
+			for (size_t c : count) {
+				size_t k = 0;
+				while ((c >> k) != 0) ++k;
+				if (k >= h.size()) h.resize(k + 1, 0);
+				++h[k];
+				mx = std::max(mx, c);
+			}
+		};
+		histogram(S.rowCount, S.rowHistogram, S.maxRowCount);
+		histogram(S.colCount, S.colHistogram, S.maxColCount);
+
+		// blocks: connected components of the nonempty rows and columns
+		std::vector<size_t> blockRows(m + n, 0), blockCols(m + n, 0);
+		for (size_t i = 0; i < m; ++i)
+			if (S.rowCount[i]) ++blockRows[forest.find(i)];
+		for (size_t j = 0; j < n; ++j)
+			if (S.colCount[j]) ++blockCols[forest.find(m + j)];
+		for (size_t x = 0; x < m + n; ++x) {
+			if (blockRows[x] == 0) continue;
+			++S.blocks;
+			if (blockRows[x] + blockCols[x] > S.largestBlockRows + S.largestBlockCols) {
+				S.largestBlockRows = blockRows[x];
+				S.largestBlockCols = blockCols[x];
+			}
+		}
+		return S;
+	}
+
+	/** Statistics of \p A, computed on each call.
+	 * \ingroup matrix
+	 */
+	template <class Matrix>
+	MatrixStatsCache::Pointer matrixStats (const Matrix& A, size_t threads = 0)
+	{
+		return std::make_shared<const MatrixStats>(MatrixStats::analyse(A, threads));
+	}
+
+}
+
+#endif // __LINBOX_matrix_stats_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
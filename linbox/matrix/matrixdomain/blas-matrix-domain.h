@@ -51,6 +51,7 @@
 #include "linbox/matrix/dense-matrix.h"
 #include "linbox/matrix/permutation-matrix.h"
 #include "linbox/matrix/factorized-matrix.h"
+#include "linbox/matrix/matrixdomain/blas-parallelism.h"
 
 
 
@@ -341,6 +342,7 @@ namespace LinBox
 	protected:
 
 		const Field  * _field;
+		BlasParallelism _par;
 
 	public:
 
@@ -400,6 +402,10 @@ namespace LinBox
 */
 		BlasMatrixDomain () {}
 		BlasMatrixDomain (const Field& F ) { init(F); }
+		//! Constructor with a parallelism policy for mul, det and rank.
+		BlasMatrixDomain (const Field& F, const BlasParallelism& P ) :
+			_par(P)
+		{ init(F); }
 
 		void init(const Field& F )
 		{
@@ -417,7 +423,7 @@ namespace LinBox
 
 		//! Copy constructor
 		BlasMatrixDomain (const BlasMatrixDomain<Field> & BMD) :
-			_field(BMD._field)
+			_field(BMD._field), _par(BMD._par)
 		{
 #if 0 // NO MORE USEFUL
 #ifndef NDEBUG
@@ -432,6 +438,11 @@ namespace LinBox
 		//! Field accessor
 		const Field& field() const { return *_field; }
 
+		//! Parallelism policy
+		const BlasParallelism& parallelism() const { return _par; }
+		//! Threads of mul, det and rank on dense matrices (0 for all, 1 for sequential).
+		void setParallelism(size_t threads) { _par.setThreads(threads); }
+
 		/*
 		 * Basics operation available matrix respecting BlasMatrix interface
 		 */
@@ -441,6 +452,12 @@ namespace LinBox
 		template <class Operand1, class Operand2, class Operand3>
 		Operand1& mul(Operand1& C, const Operand2& A, const Operand3& B) const
 		{
+			size_t t = _par.effective();
+			if (t > 1)
+				return _mul(C, A, B, t,
+					    typename MatrixContainerTrait<Operand1>::Type(),
+					    typename MatrixContainerTrait<Operand2>::Type(),
+					    typename MatrixContainerTrait<Operand3>::Type());
 			return BlasMatrixDomainMul<Field,Operand1,Operand2,Operand3>()(field(),C,A,B);
 		}
 
@@ -661,6 +678,11 @@ namespace LinBox
 		template <class Matrix>
 		unsigned int rank(const Matrix &A) const
 		{
+			size_t t = _par.effective();
+			if (t > 1) {
+				typename Matrix::matrixType A_c(A); // do copy
+				return (unsigned int) BlasParallelism::rankInPlace(field(), A_c, t);
+			}
 			return BlasMatrixDomainRank<Field,Matrix>()(field(),A);
 		}
 
@@ -668,6 +690,11 @@ namespace LinBox
 		template <class Matrix>
 		unsigned int rankInPlace(Matrix &A) const
 		{
+			size_t t = _par.effective();
+			if (t > 1) {
+				typename Matrix::subMatrixType A_v(A);
+				return (unsigned int) BlasParallelism::rankInPlace(field(), A_v, t);
+			}
 			return BlasMatrixDomainRank<Field, Matrix>()(field(),A);
 		}
 
@@ -675,6 +702,11 @@ namespace LinBox
 		template <class Matrix>
 		Element det(const Matrix &A) const
 		{
+			size_t t = _par.effective();
+			if (t > 1) {
+				typename Matrix::matrixType A_c(A); // do copy
+				return BlasParallelism::detInPlace(field(), A_c, t);
+			}
 			return BlasMatrixDomainDet<Field, Matrix>()(field(),A);
 		}
 
@@ -682,7 +714,11 @@ namespace LinBox
 		template <class Matrix>
 		Element detInPlace(Matrix &A) const
 		{
-
+			size_t t = _par.effective();
+			if (t > 1) {
+				typename Matrix::subMatrixType A_v(A);
+				return BlasParallelism::detInPlace(field(), A_v, t);
+			}
 			return BlasMatrixDomainDet<Field, Matrix>()(field(),A);
 		}
 		//@}
@@ -934,6 +970,26 @@ namespace LinBox
 			return A.read (is, field());
 		}
 
+	protected:
+
+		// dense operands: parallel fgemm
+		template <class Operand1, class Operand2, class Operand3>
+		Operand1& _mul(Operand1& C, const Operand2& A, const Operand3& B, size_t t,
+			       MatrixContainerCategory::BlasContainer,
+			       MatrixContainerCategory::BlasContainer,
+			       MatrixContainerCategory::BlasContainer) const
+		{
+			return BlasParallelism::mul(field(), C, A, B, t);
+		}
+
+		// others: sequential
+		template <class Operand1, class Operand2, class Operand3, class Tag1, class Tag2, class Tag3>
+		Operand1& _mul(Operand1& C, const Operand2& A, const Operand3& B, size_t,
+			       Tag1, Tag2, Tag3) const
+		{
+			return BlasMatrixDomainMul<Field,Operand1,Operand2,Operand3>()(field(),C,A,B);
+		}
+
 	}; /* end of class BlasMatrixDomain */
 
 } /* end of namespace LinBox */
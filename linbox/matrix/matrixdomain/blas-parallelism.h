@@ -0,0 +1,176 @@
+/* linbox/matrix/matrixdomain/blas-parallelism.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/matrixdomain/blas-parallelism.h
+ * @ingroup matrixdomain
+ * @brief Number of threads the dense FFLAS-FFPACK routines may use.
+ *
+ * A BlasParallelism is attached to a BlasMatrixDomain (or a MatrixDomain
+ * on dense matrices). It asks for a number of threads, and is turned into
+ * the \c FFLAS::ParSeqHelper::Parallel helpers, with recursive splitting,
+ * of the FFLAS-FFPACK routines. Inside an OpenMP parallel region, e.g. one
+ * CRA iteration among several, the threads of the enclosing teams are
+ * counted against \c LINBOX_MAX_THREADS (the number of processors by
+ * default), so that nested calls share the machine rather than
+ * oversubscribe it. Without OpenMP everything is sequential.
+ */
+
+#ifndef __LINBOX_blas_parallelism_H
+#define __LINBOX_blas_parallelism_H
+
+#include <algorithm>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <fflas-ffpack/fflas/fflas.h>
+#include <fflas-ffpack/ffpack/ffpack.h>
+
+#include "linbox/util/debug.h"
+
+#ifndef LINBOX_MAX_THREADS
+// cap on the total number of threads of nested parallel calls, 0 for the number of processors
+#define LINBOX_MAX_THREADS 0
+#endif
+
+namespace LinBox
+{
+
+	/** \brief Parallelism policy of the dense linear algebra domains.
+	 * \ingroup matrixdomain
+	 */
+	class BlasParallelism {
+	public:
+		//! FFLAS helper of the matrix products
+		typedef FFLAS::ParSeqHelper::Parallel<FFLAS::CuttingStrategy::Recursive,
+						      FFLAS::StrategyParameter::ThreeDAdaptive> MulHelper;
+		//! FFLAS helper of the PLUQ based routines (det, rank, solve)
+		typedef FFLAS::ParSeqHelper::Parallel<FFLAS::CuttingStrategy::Recursive,
+						      FFLAS::StrategyParameter::Threads> PLUQHelper;
+
+		/// \p threads threads, 0 for all the available ones, 1 for sequential.
+		BlasParallelism (size_t threads = 1) :
+			_threads(threads)
+		{}
+
+		size_t threads () const { return _threads; }
+		void setThreads (size_t threads) { _threads = threads; }
+
+		/// Threads to use from the calling thread: the requested ones, within the share of the cap left by the enclosing teams.
+		size_t effective () const
+		{
+#ifdef _OPENMP
+			if (_threads == 1) return 1;
+			size_t cap = LINBOX_MAX_THREADS ? (size_t)LINBOX_MAX_THREADS : (size_t)omp_get_num_procs();
+			if (omp_in_parallel()) {
+				if (omp_get_active_level() >= omp_get_max_active_levels())
+					return 1;
+				size_t outer = 1;
+				for (int l = 1; l <= omp_get_level(); ++l)
+					outer *= (size_t)omp_get_team_size(l);
+				cap = std::max((size_t)1, cap / outer);
+			}
+			size_t want = _threads ? _threads : cap;
+			return std::max((size_t)1, std::min(want, cap));
+#else
+			return 1;
+#endif
+		}
+
+		bool parallel () const { return effective() > 1; }
+
+		/// Runs \p f, which spawns FFLAS tasks, in a team of \p t threads.
+		template<class Function>
+		static void run (size_t t, Function f)
+		{
+			(void)t;
+#ifdef _OPENMP
+#pragma omp parallel num_threads((int)t)
+#pragma omp single
+#endif
+			f();
+		}
+
+		/*! @name Dense kernels on \p t threads
+		 * The operands are BlasMatrix or BlasSubmatrix.
+		 */
+		//@{
+		//! C = A*B
+		template<class Field, class Matrix1, class Matrix2, class Matrix3>
+		static Matrix1& mul (const Field& F, Matrix1& C, const Matrix2& A, const Matrix3& B, size_t t)
+		{
+			linbox_check( A.coldim() == B.rowdim());
+			linbox_check( C.rowdim() == A.rowdim());
+			linbox_check( C.coldim() == B.coldim());
+			run(t, [&]() {
+				FFLAS::fgemm(F, FFLAS::FflasNoTrans, FFLAS::FflasNoTrans,
+					     C.rowdim(), C.coldim(), A.coldim(),
+					     F.one, A.getPointer(), A.getStride(),
+					     B.getPointer(), B.getStride(),
+					     F.zero, C.getPointer(), C.getStride(),
+					     MulHelper(t));
+			});
+			return C;
+		}
+
+		//! determinant, \p A is modified
+		template<class Field, class Matrix>
+		static typename Field::Element detInPlace (const Field& F, Matrix& A, size_t t)
+		{
+			typename Field::Element d; F.init(d);
+			if (A.rowdim() != A.coldim())
+				return F.assign(d, F.zero);
+			run(t, [&]() {
+				FFPACK::Det(F, d, A.coldim(), A.getPointer(), A.getStride(), PLUQHelper(t));
+			});
+			return d;
+		}
+
+		//! rank, \p A is modified
+		template<class Field, class Matrix>
+		static size_t rankInPlace (const Field& F, Matrix& A, size_t t)
+		{
+			size_t r = 0;
+			run(t, [&]() {
+				r = FFPACK::Rank(F, A.rowdim(), A.coldim(), A.getPointer(), A.getStride(), PLUQHelper(t));
+			});
+			return r;
+		}
+		//@}
+
+	protected:
+		size_t _threads;
+	};
+
+}
+
+#endif // __LINBOX_blas_parallelism_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -0,0 +1,292 @@
+/* linbox/matrix/matrixdomain/dense-apply-engine.h
+ * Copyright (C) 2019 The LinBox group
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file matrix/matrixdomain/dense-apply-engine.h
+ * @ingroup matrixdomain
+ * @brief Repeated products of a dense matrix over a small prime field by vectors.
+ *
+ * A blackbox method applies the same matrix many times. The
+ * DenseApplyEngine converts the entries once to \c float, when the
+ * prime is small enough for the products of a long enough block of
+ * columns to be exact in single precision, or to \c double otherwise.
+ * Each apply is then a sequence of BLAS \c gemv, or \c gemm for several
+ * vectors at once, on blocks of columns, reduced modulo \p p only
+ * between two blocks. Panels of rows are shared between threads.
+ *
+ * The engine is opt-in: DenseApplyBlackbox wraps a BlasMatrix in one,
+ * BlasMatrix::apply itself never uses a packed copy.
+ */
+
+#ifndef __LINBOX_matrixdomain_dense_apply_engine_H
+#define __LINBOX_matrixdomain_dense_apply_engine_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "linbox/linbox-config.h"
+#include "linbox/config-blas.h"
+#include "linbox/util/debug.h"
+#include "linbox/matrix/matrixdomain/blas-parallelism.h"
+#include <givaro/modular.h>
+
+#ifndef LINBOX_DENSE_APPLY_THRESHOLD
+// fewest entries of a matrix for which the engine is built
+#define LINBOX_DENSE_APPLY_THRESHOLD 4096
+#endif
+
+#ifndef LINBOX_DENSE_APPLY_MIN_DELAY
+// fewest columns between two reductions, larger primes use fgemv
+#define LINBOX_DENSE_APPLY_MIN_DELAY 16
+#endif
+
+#ifndef LINBOX_DENSE_APPLY_GRAIN
+// fewest entries of a panel handled by a thread
+#define LINBOX_DENSE_APPLY_GRAIN (1 << 16)
+#endif
+
+namespace LinBox
+{
+
+	/// Whether DenseApplyEngine<Field> exists.
+	template <class Field>
+	struct DenseApplyEngineTraits {
+		static const bool value = false;
+	};
+
+	template <class T>
+	struct DenseApplyEngineTraits<Givaro::Modular<T> > {
+		static const bool value = std::is_arithmetic<T>::value;
+	};
+
+	/*! @internal BLAS on the packed copy, row major, C = A B + C. */
+	inline void denseApplyGemm (bool trans, size_t m, size_t k, size_t n, const double *A, size_t lda,
+				    const double *B, size_t ldb, double *C, size_t ldc)
+	{
+		if (k == 1)
+			cblas_dgemv(CblasRowMajor, trans ? CblasTrans : CblasNoTrans,
+				    (int)(trans ? n : m), (int)(trans ? m : n), 1., A, (int)lda, B, (int)ldb, 1., C, (int)ldc);
+		else
+			cblas_dgemm(CblasRowMajor, trans ? CblasTrans : CblasNoTrans, CblasNoTrans,
+				    (int)m, (int)k, (int)n, 1., A, (int)lda, B, (int)ldb, 1., C, (int)ldc);
+	}
+
+	inline void denseApplyGemm (bool trans, size_t m, size_t k, size_t n, const float *A, size_t lda,
+				    const float *B, size_t ldb, float *C, size_t ldc)
+	{
+		if (k == 1)
+			cblas_sgemv(CblasRowMajor, trans ? CblasTrans : CblasNoTrans,
+				    (int)(trans ? n : m), (int)(trans ? m : n), 1.f, A, (int)lda, B, (int)ldb, 1.f, C, (int)ldc);
+		else
+			cblas_sgemm(CblasRowMajor, trans ? CblasTrans : CblasNoTrans, CblasNoTrans,
+				    (int)m, (int)k, (int)n, 1.f, A, (int)lda, B, (int)ldb, 1.f, C, (int)ldc);
+	}
+
+	/** \brief Products of a dense matrix over \c Givaro::Modular<T> by blocks of vectors.
+	 * \ingroup matrixdomain
+	 *
+	 * The engine owns a packed copy of the matrix: later changes to the
+	 * matrix are not seen. Apply is reentrant; the conversion buffers are
+	 * kept per calling thread from one apply to the next. With more than
+	 * one thread, the BLAS library should be sequential.
+	 */
+	template <class Field>
+	class DenseApplyEngine {
+	public:
+		typedef typename Field::Element Element;
+
+		/** Packs the \p m x \p n matrix at \p A, of row stride \p lda.
+		 * Applies use \p threads threads, 0 for all the available ones,
+		 * within the share left by enclosing parallel regions
+		 * (see BlasParallelism).
+		 */
+		DenseApplyEngine (const Field& F, const Element* A, size_t m, size_t n, size_t lda, size_t threads = 1) :
+			_field(&F), _m(m), _n(n), _par(threads)
+		{
+			linbox_check(suitable(F));
+			_p = (double)F.characteristic();
+			const size_t delayF = delay(_p, 16777216.);
+			_float = delayF >= std::min((size_t)64, std::max(m, n));
+			_delay = _float ? delayF : delay(_p, 9007199254740992.);
+			if (_float) pack(_packedF, A, lda);
+			else pack(_packedD, A, lda);
+		}
+
+		/// Whether the products of \c LINBOX_DENSE_APPLY_MIN_DELAY entries are exact in a \c double.
+		static bool suitable (const Field& F)
+		{
+			return delay((double)F.characteristic(), 9007199254740992.) >= LINBOX_DENSE_APPLY_MIN_DELAY;
+		}
+
+		size_t rowdim () const { return _m; }
+		size_t coldim () const { return _n; }
+
+		//! Whether the packed copy is in single precision.
+		bool singlePrecision () const { return _float; }
+
+		size_t threads () const { return _par.threads(); }
+		void setThreads (size_t threads) { _par.setThreads(threads); }
+
+		//! y = A x
+		template <class OutVector, class InVector>
+		OutVector& apply (OutVector& y, const InVector& x) const
+		{
+			run(false, 1, [&](size_t j, size_t) { return x[j]; },
+			    [&](size_t i, size_t, const Element& e) { y[i] = e; });
+			return y;
+		}
+
+		//! y = A^T x
+		template <class OutVector, class InVector>
+		OutVector& applyTranspose (OutVector& y, const InVector& x) const
+		{
+			run(true, 1, [&](size_t i, size_t) { return x[i]; },
+			    [&](size_t j, size_t, const Element& e) { y[j] = e; });
+			return y;
+		}
+
+		//! Y = A X, for dense matrices with getPointer() and getStride()
+		template <class Matrix1, class Matrix2>
+		Matrix1& applyLeft (Matrix1& Y, const Matrix2& X) const
+		{
+			const Element *xp = X.getPointer();
+			Element *yp = Y.getWritePointer();
+			const size_t ldx = X.getStride(), ldy = Y.getStride();
+			run(false, X.coldim(), [&](size_t j, size_t c) { return xp[j*ldx+c]; },
+			    [&](size_t i, size_t c, const Element& e) { yp[i*ldy+c] = e; });
+			return Y;
+		}
+
+		//! Y = X A, for dense matrices with getPointer() and getStride()
+		template <class Matrix1, class Matrix2>
+		Matrix1& applyRight (Matrix1& Y, const Matrix2& X) const
+		{
+			const Element *xp = X.getPointer();
+			Element *yp = Y.getWritePointer();
+			const size_t ldx = X.getStride(), ldy = Y.getStride();
+			run(true, X.rowdim(), [&](size_t i, size_t r) { return xp[r*ldx+i]; },
+			    [&](size_t j, size_t r, const Element& e) { yp[r*ldy+j] = e; });
+			return Y;
+		}
+
+	protected:
+		const Field   *_field;
+		size_t      _m, _n;
+		double          _p;
+		bool        _float;
+		size_t      _delay; //!< columns between two reductions
+		BlasParallelism _par;
+		std::vector<float>  _packedF;
+		std::vector<double> _packedD;
+
+		// products of entries in [0,p) added to a value in [0,p) while below the bound
+		static size_t delay (double p, double bound)
+		{
+			const double d = std::floor((bound - p) / ((p - 1.) * (p - 1.)));
+			return d < 1. ? 0 : (size_t)d;
+		}
+
+		template <class Compute>
+		void pack (std::vector<Compute>& P, const Element* A, size_t lda)
+		{
+			P.resize(_m * _n);
+			for (size_t i = 0; i < _m; ++i)
+				for (size_t j = 0; j < _n; ++j)
+					P[i*_n+j] = (Compute)A[i*lda+j];
+		}
+
+		/* Out = op(A) In, op(A) being A or A^T, for k vectors: gather(j,c)
+		 * is the j-th coordinate of the c-th input vector, scatter(i,c,e)
+		 * sets the i-th coordinate of the c-th output vector to e.
+		 */
+		template <class Gather, class Scatter>
+		void run (bool trans, size_t k, Gather gather, Scatter scatter) const
+		{
+			if (_float) run(_packedF, trans, k, gather, scatter);
+			else run(_packedD, trans, k, gather, scatter);
+		}
+
+		// buffer w of the calling thread, for all the engines
+		template <class Compute>
+		static std::vector<Compute>& workspace (size_t w)
+		{
+			static thread_local std::vector<Compute> ws[2];
+			return ws[w];
+		}
+
+		template <class Compute, class Gather, class Scatter>
+		void run (const std::vector<Compute>& P, bool trans, size_t k, Gather gather, Scatter scatter) const
+		{
+			const size_t outer = trans ? _n : _m, inner = trans ? _m : _n;
+			std::vector<Compute>& X = workspace<Compute>(0);
+			std::vector<Compute>& Y = workspace<Compute>(1);
+			X.resize(inner * k);
+			Y.assign(outer * k, (Compute)0);
+			for (size_t j = 0; j < inner; ++j)
+				for (size_t c = 0; c < k; ++c)
+					X[j*k+c] = (Compute)gather(j, c);
+
+			size_t t = _par.effective();
+			t = std::max((size_t)1, std::min(t, outer * inner * k / LINBOX_DENSE_APPLY_GRAIN));
+			const size_t panel = (outer + t - 1) / t;
+			const Compute p = (Compute)_p, invp = (Compute)(1. / _p);
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads((int)t) schedule(static)
+#endif
+			for (long q = 0; q < (long)t; ++q) {
+				const size_t i0 = (size_t)q * panel, i1 = std::min(outer, i0 + panel);
+				if (i0 >= i1) continue;
+				Compute *y = &Y[i0*k];
+				for (size_t b0 = 0; b0 < inner; b0 += _delay) {
+					const size_t b1 = std::min(inner, b0 + _delay);
+					const Compute *a = trans ? &P[b0*_n+i0] : &P[i0*_n+b0];
+					denseApplyGemm(trans, i1 - i0, k, b1 - b0, a, _n, &X[b0*k], k, y, k);
+					// nonnegative, a floor off by one is corrected
+					for (size_t l = 0; l < (i1 - i0) * k; ++l) {
+						Compute r = y[l] - std::floor(y[l] * invp) * p;
+						if (r < 0) r += p;
+						if (r >= p) r -= p;
+						y[l] = r;
+					}
+				}
+			}
+
+			for (size_t i = 0; i < outer; ++i)
+				for (size_t c = 0; c < k; ++c)
+					scatter(i, c, (Element)Y[i*k+c]);
+		}
+	};
+
+}
+
+#endif // __LINBOX_matrixdomain_dense_apply_engine_H
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -48,6 +48,7 @@
 
 #include "linbox/blackbox/archetype.h"
 #include "linbox/matrix/matrix-traits.h"
+#include "linbox/matrix/matrixdomain/blas-parallelism.h"
 // #include "linbox/vector/blas-vector.h"
 
 namespace LinBox
@@ -108,9 +109,16 @@ namespace LinBox
 		{
 			_field = MD._field;
 			_VD = MD._VD;
+			_par = MD._par;
 			return *this;
 		}
 
+		/** Threads of the products of dense (BlasMatrix) matrices.
+		 * 0 for all the available ones, 1 (default) for sequential.
+		 */
+		void setParallelism (size_t threads) { _par.setThreads(threads); }
+		const BlasParallelism& parallelism () const { return _par; }
+
 		/** Retrieve the underlying field.
 		 * Return a reference to the field that this matrix domain
 		 * object uses
@@ -321,6 +329,12 @@ namespace LinBox
 		template <class Matrix1, class Matrix2, class Matrix3>
 		inline Matrix1 &mul (Matrix1 &C, const Matrix2 &A, const Matrix3 &B) const
 		{
+			size_t t = _par.effective();
+			if (t > 1)
+				return mulParallel (C, A, B, t,
+						    typename MatrixContainerTrait<Matrix1>::Type (),
+						    typename MatrixContainerTrait<Matrix2>::Type (),
+						    typename MatrixContainerTrait<Matrix3>::Type ());
 			return mulSpecialized (C, A, B,
 					       typename MatrixTraits<Matrix1>::MatrixCategory (),
 					       typename MatrixTraits<Matrix2>::MatrixCategory (),
@@ -851,6 +865,24 @@ namespace LinBox
 			return neginRow (A);
 		}
 
+		template <class Matrix1, class Matrix2, class Matrix3>
+		Matrix1 &mulParallel (Matrix1 &C, const Matrix2 &A, const Matrix3 &B, size_t t,
+				      MatrixContainerCategory::BlasContainer,
+				      MatrixContainerCategory::BlasContainer,
+				      MatrixContainerCategory::BlasContainer) const
+		{
+			return BlasParallelism::mul (field (), C, A, B, t);
+		}
+		template <class Matrix1, class Matrix2, class Matrix3, class Tag1, class Tag2, class Tag3>
+		Matrix1 &mulParallel (Matrix1 &C, const Matrix2 &A, const Matrix3 &B, size_t,
+				      Tag1, Tag2, Tag3) const
+		{
+			return mulSpecialized (C, A, B,
+					       typename MatrixTraits<Matrix1>::MatrixCategory (),
+					       typename MatrixTraits<Matrix2>::MatrixCategory (),
+					       typename MatrixTraits<Matrix3>::MatrixCategory ());
+		}
+
 		template <class Matrix1, class Matrix2, class Matrix3>
 		Matrix1 &mulRowRowCol (Matrix1 &C, const Matrix2 &A, const Matrix3 &B) const;
 		template <class Matrix1, class Matrix2, class Matrix3>
@@ -1226,6 +1258,7 @@ namespace LinBox
 
 		const Field         *_field;
 		VectorDomain<Field>  _VD;
+		BlasParallelism      _par;
 	}; //MatrixDomain
 
 }
@@ -50,7 +50,7 @@ namespace LinBox {
 		// template<typename Row_t>
 		class CSR         : public ANY {} ; //!< compressed row
 		// template<typename Row_t>
-		class CSR1        : public ANY {} ; //!< implicit value CSR (with only ones, or mones, or..)
+		class CSR1        : public ANY {} ; //!< implicit value CSR (with only ones, or mones, or..), see SignedZeroOne
 		// template<typename Row_t>
 		class ELL         : public ANY {} ; //!< ellpack
 		// template<typename Row_t>
@@ -38,6 +38,7 @@
 
 #include "linbox/matrix/sparse-formats.h"
 #include "linbox/matrix/matrix-traits.h"
+#include "linbox/matrix/matrix-stats.h"
 
 namespace LinBox {
 
@@ -37,6 +37,7 @@
 
 #include "linbox/linbox-config.h"
 #include "linbox/util/debug.h"
+#include "linbox/matrix/matrix-stats.h"
 #include "sparse-domain.h"
 #include "sparse-coo-matrix.h"
 #include "sparse-csr-matrix.h"
@@ -50,57 +51,40 @@
 namespace LinBox
 {
 
+	/*! Choice of the HYB parts of a CSR matrix.
+	 * The counts come from the statistics of the matrix (see matrixStats()).
+	 */
 	template<class Field>
 	class Stats {
-		const SparseMatrix<Field,SparseMatrixFormat::CSR> & _Mat;
-		const Field & _field ;
+		MatrixStatsCache::Pointer _stats;
 	public:
 		size_t one ;
 		size_t mone ;
-		size_t avg ;
-		// size_t avg_one ;
-		// size_t avg_mone ;
-		std::vector<size_t> row ;
-		std::vector<size_t> row_one ;
-		std::vector<size_t> row_mone ;
+		size_t avg ;                    //!< nonzeros of a nonempty row, rounded up
+		const std::vector<size_t> & row ;
 		std::vector<size_t> null_row ;
-		// size_t mean ;
 		size_t ell ;
 		size_t ell_nbnz ;
 		size_t ell_one ;
 		size_t ell_mone ;
 	public :
 		Stats( const SparseMatrix<Field,SparseMatrixFormat::CSR> & Mat) :
-			_Mat(Mat),_field(_Mat.field())
-			,one(0),mone(0)
-			,row(Mat.rowdim(),0)
-			,row_one(Mat.rowdim(),0)
-			,row_mone(Mat.rowdim(),0)
-			,null_row(0)
+			_stats(matrixStats(Mat))
+			,one(_stats->ones),mone(_stats->minusOnes)
 			,avg(0)
+			,row(_stats->rowCount)
+			,null_row(0)
 			,ell(0)
 			,ell_nbnz(0)
-			// ,_off_ell(Mat.rowdim(),0);
+			,ell_one(0)
+			,ell_mone(0)
 		{
-			if (Mat.size() > 100) { /*! @todo what is small ?  */
-				for (size_t i = 0 ; i < Mat.rowdim() ; ++i) {
-					if (Mat.getStart(i) == Mat.getEnd(i)) {
-						null_row.push_back(i);
-					}
-					for (size_t k = Mat.getStart(i) ; k < Mat.getEnd(i) ; ++k) {
-						if (_field.isOne(Mat.getEntry(k))) {
-							++one ;
-							row_one[i] += 1 ;
-						}
-						else if (_field.isMOne(Mat.getEntry(k))) {
-							++mone ;
-							row_mone[i] += 1 ;
-						}
-						row[i] += 1;
-					}
-				}
-			}
-			avg = std::ceil((Mat.rowdim()-null_row.size())/Mat.size());
+			for (size_t i = 0 ; i < row.size() ; ++i)
+				if (row[i] == 0)
+					null_row.push_back(i);
+			size_t full = Mat.rowdim()-null_row.size() ;
+			if (full)
+				avg = (_stats->nnz + full - 1) / full ;
 		}
 
 		void getOptimsedFormat(SparseMatrix<Field,SparseMatrixFormat::HYB> & hyb)
@@ -347,7 +331,7 @@ namespace LinBox
 
 		void optimise()
 		{
-			Stats<Field> stats(*this);
+			Stats<Field> stats(reader());
 			//! @todo ±1 !
 			if (have_ell_r()) {
 				ell_r().resize(rowdim(),coldim(),stats.ell_nbnz,stats.ell);
@@ -193,7 +193,7 @@ namespace LinBox
 						  const Method::Auto	       & M)
 	{
 		commentator().start ("Integer Charpoly", "Icharpoly");
-		if (useBlackboxMethod(A))
+		if (useBlackboxMethod(A, M))
 			charpoly(P, A, tag, Method::Blackbox(M) );
 		else
 			charpoly(P, A, tag, Method::DenseElimination(M) );
@@ -123,7 +123,7 @@ namespace LinBox
 						const RingCategories::ModularTag	&tag,
 						const Method::Auto			&Meth)
 	{
-		if (useBlackboxMethod(A))
+		if (useBlackboxMethod(A, Meth))
 			return det(d, A, tag, Method::Blackbox(Meth));
 		else
 
@@ -337,7 +337,7 @@ namespace LinBox
 		linbox_check (A.coldim () == A.rowdim ());
 
 		BlasMatrix<Field> B(A);
-		BlasMatrixDomain<Field> BMD(F);
+		BlasMatrixDomain<Field> BMD(F, BlasParallelism(Meth.nbThreads));
 		d= BMD.detInPlace(B);
 		commentator().stop ("done", NULL, "blasdet");
 
@@ -362,7 +362,7 @@ namespace LinBox
 			for(size_t j = 0; j < A.coldim(); ++j)
 				A1.setEntry(i,j,getEntry(tmp, A, i, j));
 		GaussDomain<Field> GD ( A1.field() );
-		GD.detInPlace (d, A1, Meth.pivotStrategy);
+		GD.detInPlace (d, A1, Meth);
 		commentator().stop ("done", NULL, "SEDet");
 		return d;
 
@@ -381,7 +381,7 @@ namespace LinBox
 		// We make a copy as these data will be destroyed
 		SparseMatrix<Field, SparseMatrixFormat::SparseSeq> A1 (A);
 		GaussDomain<Field> GD ( A.field() );
-		GD.detInPlace (d, A1, Meth.pivotStrategy);
+		GD.detInPlace (d, A1, Meth);
 		commentator().stop ("done", NULL, "SEdet");
 		return d;
 	}
@@ -396,7 +396,7 @@ namespace LinBox
 			throw LinboxError("LinBox ERROR: matrix must be square for determinant computation\n");
 		commentator().start ("Sparse Elimination Determinant in place", "SEDetin");
 		GaussDomain<Field> GD ( A.field() );
-		GD.detInPlace (d, A, Meth.pivotStrategy);
+		GD.detInPlace (d, A, Meth);
 		commentator().stop ("done", NULL, "SEdetin");
 		return d;
 	}
@@ -528,6 +528,9 @@ namespace LinBox
 #include "linbox/algorithms/cra-builder-single.h"
 #include "linbox/randiter/random-prime.h"
 #include "linbox/algorithms/matrix-hom.h"
+#include "linbox/blackbox/modular-csr-view.h"
+#include "linbox/algorithms/cra-domain-multimod.h"
+#include "linbox/algorithms/multimod-wiedemann.h"
 
 namespace LinBox
 {
@@ -536,20 +539,59 @@ namespace LinBox
 	struct IntegerModularDet {
 		const Blackbox &A;
 		const MyMethod &M;
+		IntegerCSRImage I; //!< shared word size copy of A, when it can be reduced on apply
+		typedef UseModularCSRView<Blackbox,MyMethod> ReduceOnApply;
 
 		IntegerModularDet(const Blackbox& b, const MyMethod& n) :
 			A(b), M(n)
-		{}
+		{
+			initCSRImage(I, A, ReduceOnApply());
+		}
 
 
 		template<class Element, typename Field>
 		IterationResult operator()(Element& d, const Field& F) const
+		{
+			return iterate(d, F, ReduceOnApply());
+		}
+
+		//! Number of primes sharing each apply of A, see Method::nbPrimesPerApply.
+		size_t primesPerApply() const
+		{
+			return I.fits() ? M.nbPrimesPerApply : 1;
+		}
+
+		//! The determinants modulo all the primes of \p F, in one sequence of applies.
+		template<class Element, typename Field>
+		void operator()(std::vector<IterationResult>& results, std::vector<Element>& d, const std::vector<Field>& F) const
+		{
+			if (! multiModFits(F)) {
+				for (size_t l = 0; l < F.size(); ++l)
+					results[l] = (*this)(d[l], F[l]);
+				return;
+			}
+			multiModDet(results, d, F, I, M.earlyTerminationThreshold);
+		}
+
+	protected:
+		template<class Element, typename Field>
+		IterationResult iterate(Element& d, const Field& F, std::false_type) const
 		{
 			typedef typename Blackbox::template rebind<Field>::other FBlackbox;
 			FBlackbox Ap(A, F);
 			detInPlace( d, Ap, RingCategories::ModularTag(), M);
 			return IterationResult::CONTINUE;
 		}
+
+		template<class Element, typename Field>
+		IterationResult iterate(Element& d, const Field& F, std::true_type) const
+		{
+			if (! I.fits())
+				return iterate(d, F, std::false_type());
+			ModularCSRView<Field> Ap(I, F);
+			detInPlace( d, Ap, RingCategories::ModularTag(), M);
+			return IterationResult::CONTINUE;
+		}
 	};
 
 
@@ -577,15 +619,21 @@ namespace LinBox
 
 		//  will call regular cra if C=0
 #ifdef __LINBOX_HAVE_MPI
-		ChineseRemainderDistributed< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD, C);
+		ChineseRemainderDistributed< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD, C, true);
 		cra(dd, iteration, genprime);
 		if(!C || C->rank() == 0){
 			A.field().init(d, dd); // convert the result from integer to original type
 			commentator().stop ("done", NULL, "det");
 		}
 #else
-		ChineseRemainder< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
-		cra(dd, iteration, genprime);
+		if (iteration.primesPerApply() > 1) {
+			ChineseRemainderMultiMod< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD, iteration.primesPerApply());
+			cra(dd, iteration, genprime);
+		}
+		else {
+			ChineseRemainder< CRABuilderEarlySingle< Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
+			cra(dd, iteration, genprime);
+		}
 		A.field().init(d, dd); // convert the result from integer to original type
 		commentator().stop ("done", NULL, "idet");
 #endif
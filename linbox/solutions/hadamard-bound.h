@@ -25,9 +25,27 @@
 #include <linbox/field/field-traits.h>
 #include <linbox/integer.h>
 #include <linbox/matrix/matrix-category.h>
+#include <linbox/matrix/matrix-stats.h>
 #include <linbox/matrix/matrix-traits.h>
+#include <linbox/util/error.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#ifndef LINBOX_HADAMARD_COLUMN_BLOCK
+// columns of G behind one lock in ParallelHadamardBound
+#define LINBOX_HADAMARD_COLUMN_BLOCK 1024
+#endif
+
+#ifndef LINBOX_HADAMARD_COLUMN_BATCH
+// entries a thread keeps before adding them to the columns
+#define LINBOX_HADAMARD_COLUMN_BATCH 4096
+#endif
 
 namespace LinBox {
 
@@ -266,6 +284,443 @@ namespace LinBox {
         return data;
     }
 
+    // ----- Parallel and streaming bounds
+
+    /**
+     * Sum of nonnegative reals \f$m 2^e\f$, kept as \c mant \f$2^{exp}\f$ so that
+     * it does not overflow, with the number of terms for the rounding errors.
+     */
+    struct HadamardLogSum {
+        double mant = 0.0;
+        long exp = 0;
+        size_t terms = 0;
+
+        void add(double m, long e)
+        {
+            ++terms;
+            if (e == exp) {
+                mant += m;
+            }
+            else if (mant == 0.0) {
+                mant = m;
+                exp = e;
+            }
+            else if (e < exp) {
+                mant += std::ldexp(m, (int)std::max(e - exp, -2000l));
+            }
+            else {
+                mant = std::ldexp(mant, (int)std::max(exp - e, -2000l)) + m;
+                exp = e;
+            }
+            if (mant > 1e270) {
+                mant = std::ldexp(mant, -900);
+                exp += 900;
+            }
+        }
+
+        void merge(const HadamardLogSum& other)
+        {
+            if (other.terms == 0) return;
+            add(other.mant, other.exp);
+            terms += other.terms - 1;
+        }
+
+        bool zero() const { return mant == 0.0; }
+
+        /// Upper bound on the bit size of the sum: each term and each addition
+        /// were rounded to nearest, a relative error of at most \f$2^{-53}\f$.
+        double log2() const
+        {
+            return std::log2(mant) + (double)exp + 1.5 * (3.0 * (double)terms + 4.0) * 2.220446049250313e-16;
+        }
+    };
+
+    //! @internal |a| as m 2^e, small values with e = 0.
+    inline void hadamardSplit(double& m, long& e, const Integer& a)
+    {
+        m = std::fabs(mpz_get_d_2exp(&e, a.get_mpz_const()));
+        if (e <= 500) {
+            m = std::ldexp(m, (int)e);
+            e = 0;
+        }
+    }
+
+    template <class Element>
+    inline void hadamardSplit(double& m, long& e, const Element& a, std::true_type /* arithmetic */)
+    {
+        m = std::fabs((double)a);
+        e = 0;
+        if (m > 1e150) {
+            int k;
+            m = std::frexp(m, &k);
+            e = k;
+        }
+    }
+
+    template <class Field>
+    inline void hadamardSplit(double& m, long& e, const Field&, const typename Field::Element& a, std::integral_constant<int, 1>)
+    {
+        hadamardSplit(m, e, a, std::true_type());
+    }
+
+    template <class Field>
+    inline void hadamardSplit(double& m, long& e, const Field&, const typename Field::Element& a, std::integral_constant<int, 2>)
+    {
+        hadamardSplit(m, e, a);
+    }
+
+    template <class Field>
+    inline void hadamardSplit(double& m, long& e, const Field& F, const typename Field::Element& a, std::integral_constant<int, 0>)
+    {
+        Integer tmp;
+        F.convert(tmp, a);
+        hadamardSplit(m, e, tmp);
+    }
+
+    template <class Field>
+    inline void hadamardSplit(double& m, long& e, const Field& F, const typename Field::Element& a)
+    {
+        typedef typename Field::Element Element;
+        hadamardSplit(m, e, F, a, std::integral_constant<int, std::is_arithmetic<Element>::value ? 1 : std::is_same<Element, Integer>::value ? 2 : 0>());
+    }
+
+    /**
+     * Row and column norms of an integer matrix, in floating point.
+     *
+     * Entries are added one at a time, in any order, so the accumulator can
+     * be filled while the matrix is read (e.g. from MatrixStream::nextTriple),
+     * or by several threads on disjoint parts that are merged afterwards.
+     * Each entry must be added once.
+     *
+     * Besides the Hadamard bounds, the accumulator gives a bound on the
+     * eigenvalues of a square matrix from the ovals of Cassini of its rows
+     * and columns, hence on the coefficients of its characteristic and
+     * minimal polynomials. All the bounds are rounded upwards.
+     */
+    class HadamardBoundAccumulator {
+    public:
+        HadamardBoundAccumulator(size_t m = 0, size_t n = 0) { resize(m, n); }
+
+        void resize(size_t m, size_t n)
+        {
+            _m = m;
+            _n = n;
+            _rowNorms.assign(m, HadamardLogSum());
+            _rowRadii.assign(m, HadamardLogSum());
+            _diag.assign(std::min(m, n), HadamardLogSum());
+            _colNorms.assign(n, HadamardLogSum());
+            _colRadii.assign(n, HadamardLogSum());
+        }
+
+        size_t rowdim() const { return _m; }
+        size_t coldim() const { return _n; }
+
+        template <class Field>
+        void addEntry(const Field& F, size_t i, size_t j, const typename Field::Element& a)
+        {
+            if (F.isZero(a)) return;
+            double v;
+            long e;
+            hadamardSplit(v, e, F, a);
+            addEntry(i, j, v, e);
+        }
+
+        /// Adds the nonzero entry \f$|a_{ij}| = v 2^e\f$.
+        void addEntry(size_t i, size_t j, double v, long e)
+        {
+            ++_nnz;
+            addRowEntry(i, j, v, e);
+            addColEntry(i, j, v, e);
+        }
+
+        /// Row part of addEntry, for threads sharing the rows.
+        void addRowEntry(size_t i, size_t j, double v, long e)
+        {
+            _rowNorms[i].add(v * v, 2 * e);
+            if (i == j)
+                _diag[i].add(v, e);
+            else
+                _rowRadii[i].add(v, e);
+        }
+
+        /// Column part of addEntry, for threads sharing the columns.
+        void addColEntry(size_t i, size_t j, double v, long e)
+        {
+            _colNorms[j].add(v * v, 2 * e);
+            if (i != j) _colRadii[j].add(v, e);
+        }
+
+        /// Counts \p k entries given by addRowEntry and addColEntry.
+        void addNonZeros(size_t k) { _nnz += k; }
+
+        void merge(const HadamardBoundAccumulator& other)
+        {
+            _nnz += other._nnz;
+            for (size_t i = 0; i < _m; ++i) {
+                _rowNorms[i].merge(other._rowNorms[i]);
+                _rowRadii[i].merge(other._rowRadii[i]);
+            }
+            for (size_t i = 0; i < _diag.size(); ++i) _diag[i].merge(other._diag[i]);
+            for (size_t j = 0; j < _n; ++j) {
+                _colNorms[j].merge(other._colNorms[j]);
+                _colRadii[j].merge(other._colRadii[j]);
+            }
+        }
+
+        size_t nonZeros() const { return _nnz; }
+
+        /// Upper bound on the rank: the number of nonzero rows or columns.
+        size_t structuralRank() const
+        {
+            size_t r = 0, c = 0;
+            for (const auto& s : _rowNorms) r += s.zero() ? 0 : 1;
+            for (const auto& s : _colNorms) c += s.zero() ? 0 : 1;
+            return std::min(r, c);
+        }
+
+        /**
+         * Hadamard bound on the minors of order \p rank: the product of
+         * the \p rank largest row norms, or column norms.
+         * For \p rank = min(m, n), it is the bound of DetailedHadamardBound.
+         */
+        HadamardLogBoundDetails details(size_t rank) const
+        {
+            double rowLogBound, rowMinLogNorm, colLogBound, colMinLogNorm;
+            largestNorms(rowLogBound, rowMinLogNorm, _rowNorms, rank);
+            largestNorms(colLogBound, colMinLogNorm, _colNorms, rank);
+
+            HadamardLogBoundDetails data;
+            data.logBound = std::min(rowLogBound, colLogBound);
+            data.logBoundOverMinNorm = std::min(rowLogBound - rowMinLogNorm, colLogBound - colMinLogNorm);
+            return data;
+        }
+
+        HadamardLogBoundDetails details() const { return details(std::min(_m, _n)); }
+
+        /**
+         * Bit size of a bound on the eigenvalues of the square matrix:
+         * the ovals of Cassini (Brauer) of its rows and of its columns.
+         * Returns \c -infinity for a zero matrix.
+         */
+        double eigenvalueLogBound() const
+        {
+            if (_m != _n) throw LinboxError("eigenvalue bound of a non square matrix");
+
+            // common scale 2^E of the diagonal and the radii
+            double E = -std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < _n; ++i) {
+                if (!_diag[i].zero()) E = std::max(E, _diag[i].log2());
+                if (!_rowRadii[i].zero()) E = std::max(E, _rowRadii[i].log2());
+                if (!_colRadii[i].zero()) E = std::max(E, _colRadii[i].log2());
+            }
+            if (E == -std::numeric_limits<double>::infinity()) return E;
+            long scale = (long)std::ceil(E);
+
+            std::vector<double> a(_n);
+            for (size_t i = 0; i < _n; ++i) a[i] = scaled(_diag[i], scale);
+            double rho = std::min(cassini(a, _rowRadii, scale), cassini(a, _colRadii, scale));
+
+            // the scaled sums lost at most one rounding per term, and the ovals a few more
+            return std::log2(rho) + (double)scale + 1.5 * (2.0 * (double)_nnz + 64.0) * 2.220446049250313e-16;
+        }
+
+        /**
+         * Bit size of a bound on the coefficients of the characteristic
+         * polynomial (and of the minimal polynomial), from the eigenvalue
+         * bound \f$\rho\f$: at most \p rank eigenvalues are nonzero, so the
+         * coefficient of degree \f$n-k\f$ is at most \f$\binom{r}{k}\rho^k\f$.
+         */
+        double charPolyLogBound(size_t rank) const
+        {
+            double logRho = eigenvalueLogBound();
+            size_t r = std::min(rank, _n);
+            double logBound = 0.0; // the leading coefficient
+            if (logRho == -std::numeric_limits<double>::infinity()) return logBound;
+            const double log2e = 1.4426950408889634;
+            for (size_t k = 1; k <= r; ++k) {
+                double logBinomial = (std::lgamma((double)r + 1.) - std::lgamma((double)k + 1.) - std::lgamma((double)(r - k) + 1.)) * log2e;
+                logBound = std::max(logBound, logBinomial + (double)k * logRho);
+            }
+            return logBound + 1e-9 * (double)(r + 1);
+        }
+
+        double charPolyLogBound() const { return charPolyLogBound(structuralRank()); }
+
+    protected:
+        size_t _m = 0, _n = 0;
+        size_t _nnz = 0;
+        std::vector<HadamardLogSum> _rowNorms; //!< squared euclidean norms
+        std::vector<HadamardLogSum> _rowRadii; //!< off-diagonal absolute sums
+        std::vector<HadamardLogSum> _diag;
+        std::vector<HadamardLogSum> _colNorms;
+        std::vector<HadamardLogSum> _colRadii;
+
+        static void largestNorms(double& logBound, double& minLogNorm, const std::vector<HadamardLogSum>& norms, size_t rank)
+        {
+            logBound = 0.0;
+            minLogNorm = 0.0;
+            size_t r = std::min(rank, norms.size());
+            if (r == 0) return;
+
+            std::vector<double> logNorms(norms.size());
+            for (size_t i = 0; i < norms.size(); ++i) {
+                // a zero norm among the r largest: the minors vanish
+                logNorms[i] = norms[i].zero() ? -std::numeric_limits<double>::infinity() : norms[i].log2() / 2.0;
+            }
+            std::nth_element(logNorms.begin(), logNorms.begin() + (ptrdiff_t)(r - 1), logNorms.end(), std::greater<double>());
+            minLogNorm = logNorms[r - 1];
+            if (minLogNorm == -std::numeric_limits<double>::infinity()) {
+                minLogNorm = 0.0;
+                return;
+            }
+            for (size_t i = 0; i < r; ++i) logBound += logNorms[i];
+            // rounding errors of the sum
+            logBound += (double)(r + 2) * 2.220446049250313e-16 * std::fabs(logBound);
+        }
+
+        // s 2^-scale rounded upwards, 1e-300 if it underflows
+        static double scaled(const HadamardLogSum& s, long scale)
+        {
+            if (s.zero()) return 0.0;
+            double v = std::ldexp(s.mant, (int)std::max(s.exp - scale, -2000l));
+            return std::max(v, 1e-300);
+        }
+
+        // largest |lambda| with |lambda - a_i||lambda - a_j| <= R_i R_j
+        static double oval(double ai, double Ri, double aj, double Rj)
+        {
+            double d = ai - aj;
+            return (ai + aj + std::sqrt(d * d + 4.0 * Ri * Rj)) / 2.0;
+        }
+
+        /*
+         * max over i != j of the ovals, exactly on the pairs of the K largest
+         * Gershgorin discs, and bounded on the others by the largest diagonal
+         * and radius outside them (the ovals grow with both).
+         */
+        static double cassini(const std::vector<double>& a, const std::vector<HadamardLogSum>& radii, long scale)
+        {
+            const size_t n = a.size(), K = std::min(n, (size_t)64);
+            std::vector<double> R(n);
+            std::vector<size_t> order(n);
+            double gershgorin = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                R[i] = scaled(radii[i], scale);
+                gershgorin = std::max(gershgorin, a[i] + R[i]);
+                order[i] = i;
+            }
+            if (n < 2) return gershgorin;
+
+            std::partial_sort(order.begin(), order.begin() + (ptrdiff_t)K, order.end(),
+                              [&](size_t x, size_t y) { return a[x] + R[x] > a[y] + R[y]; });
+            double aRest = 0.0, RRest = 0.0;
+            for (size_t k = K; k < n; ++k) {
+                aRest = std::max(aRest, a[order[k]]);
+                RRest = std::max(RRest, R[order[k]]);
+            }
+
+            double rho = 0.0;
+            for (size_t x = 0; x < K; ++x) {
+                size_t i = order[x];
+                for (size_t y = x + 1; y < K; ++y) rho = std::max(rho, oval(a[i], R[i], a[order[y]], R[order[y]]));
+                if (K < n) rho = std::max(rho, oval(a[i], R[i], aRest, RRest));
+            }
+            if (n - K >= 2) rho = std::max(rho, aRest + RRest);
+            return std::min(rho, gershgorin);
+        }
+    };
+
+    /**
+     * Row and column norms of \p A, in one parallel pass over its rows
+     * when the storage gives access to a row (see MatrixStats).
+     */
+    template <class IMatrix>
+    HadamardBoundAccumulator ParallelHadamardBound(const IMatrix& A, size_t threads = 0)
+    {
+        typedef MatrixStatsEntries<IMatrix> Entries;
+        typedef typename IMatrix::Field::Element Element;
+        const size_t m = A.rowdim(), n = A.coldim();
+        HadamardBoundAccumulator G(m, n);
+
+        if (!Entries::rowAccess) {
+            Entries::all(A, [&](size_t i, size_t j, const Element& a) { G.addEntry(A.field(), i, j, a); });
+            return G;
+        }
+
+        size_t t = 1;
+#ifdef _OPENMP
+        t = threads ? threads : (size_t)omp_get_max_threads();
+        t = std::max((size_t)1, std::min(t, m / LINBOX_MATRIX_STATS_GRAIN));
+#endif
+        (void)threads;
+
+        if (t == 1) {
+            for (size_t i = 0; i < m; ++i)
+                Entries::row(A, i, [&](size_t j, const Element& a) { G.addEntry(A.field(), i, j, a); });
+            return G;
+        }
+
+        /*
+         * The rows are shared between the threads. Each one keeps a batch of
+         * its entries, sorted by column when full and added to the columns of
+         * G one block of columns at a time, under the lock of the block.
+         */
+        struct ColumnEntry {
+            size_t i, j;
+            double v;
+            long e;
+        };
+        const size_t blocks = (n + LINBOX_HADAMARD_COLUMN_BLOCK - 1) / LINBOX_HADAMARD_COLUMN_BLOCK;
+        std::vector<std::mutex> locks(blocks);
+        auto flush = [&](std::vector<ColumnEntry>& batch) {
+            std::sort(batch.begin(), batch.end(), [](const ColumnEntry& x, const ColumnEntry& y) { return x.j < y.j; });
+            for (size_t k = 0; k < batch.size();) {
+                const size_t b = batch[k].j / LINBOX_HADAMARD_COLUMN_BLOCK;
+                std::lock_guard<std::mutex> guard(locks[b]);
+                for (; k < batch.size() && batch[k].j / LINBOX_HADAMARD_COLUMN_BLOCK == b; ++k)
+                    G.addColEntry(batch[k].i, batch[k].j, batch[k].v, batch[k].e);
+            }
+            batch.clear();
+        };
+
+        size_t nnz = 0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads((int)t) reduction(+ : nnz)
+#endif
+        {
+            std::vector<ColumnEntry> batch;
+            batch.reserve(LINBOX_HADAMARD_COLUMN_BATCH);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, LINBOX_MATRIX_STATS_GRAIN) nowait
+#endif
+            for (long i = 0; i < (long)m; ++i) {
+                Entries::row(A, (size_t)i, [&](size_t j, const Element& a) {
+                    ColumnEntry c = {(size_t)i, j, 0.0, 0};
+                    hadamardSplit(c.v, c.e, A.field(), a);
+                    G.addRowEntry(c.i, j, c.v, c.e);
+                    batch.push_back(c);
+                    if (batch.size() == LINBOX_HADAMARD_COLUMN_BATCH) flush(batch);
+                    ++nnz;
+                });
+            }
+            flush(batch);
+        }
+        G.addNonZeros(nnz);
+        return G;
+    }
+
+    template <class Field, class Rep>
+    HadamardLogBoundDetails DetailedHadamardBound(const BlasMatrix<Field, Rep>& A)
+    {
+        return ParallelHadamardBound(A).details();
+    }
+
+    template <class Field, class Storage>
+    HadamardLogBoundDetails DetailedHadamardBound(const SparseMatrix<Field, Storage>& A)
+    {
+        return ParallelHadamardBound(A).details();
+    }
+
     // ----- Hadamard bound
 
     /**
@@ -310,6 +765,16 @@ namespace LinBox {
         return max;
     }
 
+    /**
+     * Returns the maximal absolute value.
+     */
+    template <class IMatrix>
+    inline Integer& InfinityNorm(Integer& max, const IMatrix& A)
+    {
+        typename MatrixTraits<IMatrix>::MatrixCategory tag;
+        return InfinityNorm(max, A, tag);
+    }
+
      /**
       * Returns the bit size of the Hadamard bound.
       * This is a larger estimation but faster to compute.
@@ -378,19 +843,44 @@ namespace LinBox {
         return Givaro::logtwo(ggb)*A.coldim()/2.0;
     }
 
+        /**
+         * Bound on the coefficients of the characteristic polynomial from
+         * the ovals of Cassini of the rows and columns, and the number of
+         * nonzero rows and columns (see HadamardBoundAccumulator).
+         * Only computed for matrices whose entries can be read.
+         */
+    template <class IMatrix>
+    inline double FastCharPolyCassiniBound(const IMatrix& A)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    template <class Field, class Rep>
+    inline double FastCharPolyCassiniBound(const BlasMatrix<Field, Rep>& A)
+    {
+        return ParallelHadamardBound(A).charPolyLogBound();
+    }
+
+    template <class Field, class Storage>
+    inline double FastCharPolyCassiniBound(const SparseMatrix<Field, Storage>& A)
+    {
+        return ParallelHadamardBound(A).charPolyLogBound();
+    }
+
     template <class IMatrix>
     inline double FastCharPolyHadamardBound(const IMatrix& A)
     {
-        typename MatrixTraits<IMatrix>::MatrixCategory tag;
         Integer infnorm;
-        InfinityNorm(infnorm, A, tag);
+        InfinityNorm(infnorm, A);
         const double DPWbound = FastCharPolyDumasPernetWanBound(A, infnorm);
         const double GGbound = FastCharPolyGoldsteinGrahamBound(A, infnorm);
+        const double Cassinibound = FastCharPolyCassiniBound(A);
 #ifdef DEBUG_HADAMARD_BOUND
         std::clog << "DPWbound: " << DPWbound << std::endl;
         std::clog << "GGbound : " << GGbound << std::endl;
+        std::clog << "Cassinibound : " << Cassinibound << std::endl;
 #endif
-        return std::min(DPWbound,GGbound);
+        return std::min(std::min(DPWbound,GGbound), Cassinibound);
     }
 
 
@@ -0,0 +1,287 @@
+/*
+ * Copyright(C) LinBox
+ *
+ * ========LICENCE========
+ * This file is part of the library LinBox.
+ *
+ * LinBox is free software: you can redistribute it and/or modify
+ * it under the terms of the  GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * ========LICENCE========
+ */
+
+/*! @file solutions/method-cost.h
+ * @ingroup solutions
+ * @brief Machine profile and cost model behind Method::Auto.
+ *
+ * The profile holds the throughput of the basic kernels on the host, as
+ * measured by benchmarks/benchmark-calibrate: sparse matrix-vector
+ * products, dense PLUQ, one CRT step and one p-adic lifting step, all
+ * modulo a word size prime. It is read once, from the file named by the
+ * \c LINBOX_PROFILE environment variable, or \c LINBOX_PROFILE_FILE.
+ * Without a profile, Method::Auto keeps deciding on the dimensions only.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <linbox/integer.h>
+#include <linbox/matrix/matrix-stats.h>
+#include <linbox/util/commentator.h>
+
+#if !defined(LINBOX_PROFILE_FILE)
+// machine profile read when LINBOX_PROFILE is not set, empty for none
+#define LINBOX_PROFILE_FILE ""
+#endif
+
+namespace LinBox {
+
+    /**
+     * Throughput of the kernels of the host, in seconds per operation,
+     * measured on one core, modulo a word size prime.
+     */
+    struct MachineProfile {
+        double spmv = 0.;     //!< per nonzero of a sparse matrix-vector product
+        double denseLU = 0.;  //!< per multiply-add of a dense PLUQ
+        double craPrime = 0.; //!< per entry of a residue added to a CRT reconstruction
+        double lifting = 0.;  //!< per multiply-add of a p-adic lifting step
+        size_t cores = 1;     //!< cores of the host
+        size_t memory = 0;    //!< bytes available for a dense copy of a matrix, 0 if unknown
+
+        bool valid() const { return (spmv > 0.) && (denseLU > 0.); }
+
+        /// Reads "key value" lines, '#' starting a comment.
+        bool read(std::istream& is)
+        {
+            std::string line;
+            while (std::getline(is, line)) {
+                std::istringstream ls(line.substr(0, line.find('#')));
+                std::string key;
+                if (!(ls >> key)) continue;
+                if (key == "spmv") ls >> spmv;
+                else if (key == "denseLU") ls >> denseLU;
+                else if (key == "craPrime") ls >> craPrime;
+                else if (key == "lifting") ls >> lifting;
+                else if (key == "cores") ls >> cores;
+                else if (key == "memory") ls >> memory;
+                if (ls.fail()) return false;
+            }
+            cores = std::max(cores, (size_t)1);
+            return valid();
+        }
+
+        std::ostream& write(std::ostream& os) const
+        {
+            os << "# LinBox machine profile, seconds per operation on one core" << std::endl;
+            os << "spmv " << spmv << std::endl;
+            os << "denseLU " << denseLU << std::endl;
+            os << "craPrime " << craPrime << std::endl;
+            os << "lifting " << lifting << std::endl;
+            os << "cores " << cores << std::endl;
+            os << "memory " << memory << std::endl;
+            return os;
+        }
+
+        bool load(const std::string& filename)
+        {
+            std::ifstream is(filename);
+            return is && read(is);
+        }
+
+        bool save(const std::string& filename) const
+        {
+            std::ofstream os(filename);
+            return os && write(os);
+        }
+
+        /// File of the host profile.
+        static std::string defaultFile()
+        {
+            const char* env = std::getenv("LINBOX_PROFILE");
+            return env ? std::string(env) : std::string(LINBOX_PROFILE_FILE);
+        }
+
+        /// Profile of the host, read on first use; not valid if there is none.
+        static const MachineProfile& host()
+        {
+            static const MachineProfile profile = loadDefault();
+            return profile;
+        }
+
+    private:
+        static MachineProfile loadDefault()
+        {
+            MachineProfile profile;
+            std::string filename = defaultFile();
+            if (!filename.empty() && !profile.load(filename)) {
+                commentator().report(Commentator::LEVEL_IMPORTANT, INTERNAL_WARNING)
+                    << "ignoring invalid machine profile " << filename << std::endl;
+                profile = MachineProfile();
+            }
+            return profile;
+        }
+    };
+
+    /// Statistics of \p A, computed on demand when its entries can be read, null for a blackbox.
+    template <class Matrix>
+    MatrixStatsCache::Pointer knownStats(const Matrix&)
+    {
+        return MatrixStatsCache::Pointer();
+    }
+
+    template <class Field, class Storage>
+    MatrixStatsCache::Pointer knownStats(const SparseMatrix<Field, Storage>& A)
+    {
+        return matrixStats(A);
+    }
+
+    template <class Field, class Rep>
+    MatrixStatsCache::Pointer knownStats(const BlasMatrix<Field, Rep>& A)
+    {
+        return matrixStats(A);
+    }
+
+    /**
+     * Estimated run times of the methods on a \f$m\times n\f$ matrix
+     * with \c nnz nonzero entries over a field of \c bits bits.
+     *
+     * Blackbox methods do \f$2\max(m,n)\f$ sparse applies and dot
+     * products, sequentially. Elimination is costed as the dense PLUQ it
+     * falls back to when the matrix fills in, shared between the threads,
+     * and is ruled out when the dense matrix does not fit in memory.
+     * Beyond 53 bits, the dense kernels lose BLAS and run at the sparse
+     * rate, and all operations cost the square of the number of words.
+     *
+     * Given the statistics of the matrix, elimination is also costed
+     * within the band of a banded matrix, and block by block on a matrix
+     * made of independent diagonal blocks.
+     */
+    class MethodCost {
+    public:
+        MethodCost(const MachineProfile& profile, size_t threads = 1, size_t processes = 1)
+            : _profile(profile)
+            , _threads(std::max(threads ? threads : profile.cores, (size_t)1))
+            , _processes(std::max(processes, (size_t)1))
+        {
+        }
+
+        double blackbox(size_t m, size_t n, size_t nnz, size_t bits) const
+        {
+            double N = (double)std::max(m, n);
+            return 2. * N * ((double)nnz + 2. * N) * _profile.spmv * words(bits);
+        }
+
+        double elimination(size_t m, size_t n, size_t bits) const
+        {
+            if (!fitsDense(m, n)) return HUGE_VAL;
+            double r = (double)std::min(m, n);
+            double ops = (double)m * (double)n * r - ((double)m + (double)n) * r * r / 2. + r * r * r / 3.;
+            double rate = (bits <= 53) ? _profile.denseLU : _profile.spmv;
+            return ops * rate * words(bits) / (double)_threads;
+        }
+
+        double blackbox(const MatrixStats& S, size_t bits) const
+        {
+            return blackbox(S.rowdim, S.coldim, S.nnz, bits);
+        }
+
+        double elimination(const MatrixStats& S, size_t bits) const
+        {
+            double cost = elimination(S.rowdim, S.coldim, bits);
+            if (S.blocks > 1) {
+                double block = elimination(S.largestBlockRows, S.largestBlockCols, bits);
+                cost = std::min(cost, (double)S.blocks * block);
+            }
+            // the fill-in stays within the band: each pivot updates lower x (lower + upper) entries
+            double lower = (double)S.lowerBandwidth + 1., width = lower + (double)S.upperBandwidth;
+            double banded = (double)std::min(S.rowdim, S.coldim) * lower * width * _profile.spmv * words(bits);
+            return std::min(cost, banded);
+        }
+
+        //! One modular solution, by the cheapest method.
+        double modular(size_t m, size_t n, size_t nnz, size_t bits) const
+        {
+            return std::min(blackbox(m, n, nnz, bits), elimination(m, n, bits));
+        }
+
+        double modular(const MatrixStats& S, size_t bits) const
+        {
+            return std::min(blackbox(S, bits), elimination(S, bits));
+        }
+
+        //! p-adic lifting of a square system to \p steps digits.
+        double dixon(size_t n, size_t nnz, size_t steps) const
+        {
+            double nn = (double)n * (double)n;
+            return modular(n, n, nnz, 32) + (double)steps * (nn + (double)nnz) * _profile.lifting;
+        }
+
+        double dixon(const MatrixStats& S, size_t steps) const
+        {
+            double nn = (double)S.coldim * (double)S.coldim;
+            return modular(S, 32) + (double)steps * (nn + (double)S.nnz) * _profile.lifting;
+        }
+
+        //! Chinese remaindering of a square system over \p primes primes, shared between the threads and processes.
+        double cra(size_t n, size_t nnz, size_t primes) const
+        {
+            double perPrime = MethodCost(_profile, 1).modular(n, n, nnz, 32) + (double)n * _profile.craPrime;
+            return (double)primes * perPrime / (double)(_threads * _processes);
+        }
+
+        double cra(const MatrixStats& S, size_t primes) const
+        {
+            double perPrime = MethodCost(_profile, 1).modular(S, 32) + (double)S.coldim * _profile.craPrime;
+            return (double)primes * perPrime / (double)(_threads * _processes);
+        }
+
+        bool fitsDense(size_t m, size_t n) const
+        {
+            return (_profile.memory == 0) || ((double)m * (double)n * sizeof(double) <= (double)_profile.memory);
+        }
+
+        template <class Matrix>
+        static size_t fieldBits(const Matrix& A)
+        {
+            Integer c;
+            A.field().cardinality(c);
+            return (c > 0) ? (size_t)c.bitsize() : 32;
+        }
+
+    protected:
+        const MachineProfile& _profile;
+        size_t _threads;
+        size_t _processes;
+
+        static double words(size_t bits)
+        {
+            double w = std::ceil((double)bits / 64.);
+            return std::max(w * w, 1.);
+        }
+    };
+}
+
+// Local Variables:
+// mode: C++
+// tab-width: 4
+// indent-tabs-mode: nil
+// c-basic-offset: 4
+// End:
+// vim:sts=4:sw=4:ts=4:et:sr:cino=>s,f0,{0,g0,(0,\:0,t0,+0,=s
@@ -25,6 +25,7 @@
 #include <linbox/field/field-traits.h>
 #include <linbox/matrix/dense-matrix.h> // Only for useBlackboxMethod
 #include <linbox/solutions/constants.h>
+#include <linbox/solutions/method-cost.h>
 #include <linbox/util/mpicpp.h>
 #include <string>
 
@@ -66,19 +67,6 @@
 
 namespace LinBox {
 
-    // Used to decide which method to use when using Method::Auto on a Blackbox or Sparse matrix.
-    template <class Matrix>
-    bool useBlackboxMethod(const Matrix& A)
-    {
-        return (A.coldim() > LINBOX_USE_BLACKBOX_THRESHOLD) && (A.rowdim() > LINBOX_USE_BLACKBOX_THRESHOLD);
-    }
-
-    template <class Field>
-    bool useBlackboxMethod(const LinBox::DenseMatrix<Field>& A)
-    {
-        return false;
-    }
-
     /**
      * Rank of the system, if known.
      */
@@ -230,10 +218,37 @@ namespace LinBox {
         // ----- For block-based methods.
         size_t blockingFactor = LINBOX_DEFAULT_BLOCKING_FACTOR; //!< Size of blocks.
 
+        // ----- For dense elimination methods.
+        size_t nbThreads = 1; //!< Threads of the FFLAS-FFPACK routines (0 for all available ones).
+
         // ----- For Wiedemann (Berlekamp Massey) methods.
         size_t earlyTerminationThreshold = LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD;
+        size_t nbProjections = 1; //!< Number of left projections sharing each apply of the blackbox.
+        size_t nbPrimesPerApply = 1; //!< Number of primes of an integer CRA sharing each apply of a sparse matrix, one such batch per OpenMP thread.
     };
 
+    // Used to decide which method to use when using Method::Auto on a Blackbox or Sparse matrix:
+    // the cost model of the machine profile when there is one and the entries can be read,
+    // the dimensions otherwise.
+    template <class Matrix>
+    bool useBlackboxMethod(const Matrix& A, const MethodBase& m = MethodBase())
+    {
+        const MachineProfile& profile = MachineProfile::host();
+        MatrixStatsCache::Pointer stats;
+        if (profile.valid() && (stats = knownStats(A))) {
+            MethodCost cost(profile, m.nbThreads);
+            size_t bits = MethodCost::fieldBits(A);
+            return cost.blackbox(*stats, bits) < cost.elimination(*stats, bits);
+        }
+        return (A.coldim() > LINBOX_USE_BLACKBOX_THRESHOLD) && (A.rowdim() > LINBOX_USE_BLACKBOX_THRESHOLD);
+    }
+
+    template <class Field>
+    bool useBlackboxMethod(const LinBox::DenseMatrix<Field>& A, const MethodBase& m = MethodBase())
+    {
+        return false;
+    }
+
     /**
      * Define which method to use when working on a system.
      */
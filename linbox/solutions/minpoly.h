@@ -107,6 +107,9 @@ namespace LinBox
 			     const RingCategories::ModularTag & tag,
 			     const Method::Auto             & M)
 	{
+		// without a machine profile, always Wiedemann
+		if (MachineProfile::host().valid() && !useBlackboxMethod(A, M))
+			return minpoly(P, A, tag, Method::Elimination(M));
 		return minpoly(P, A, tag, Method::Blackbox(M));
 	}
 
@@ -187,8 +190,11 @@ namespace LinBox
 
 #include "linbox/ring/modular.h"
 #include "linbox/algorithms/cra-domain.h"
+#include "linbox/algorithms/cra-domain-multimod.h"
 #include "linbox/randiter/random-prime.h"
 #include "linbox/algorithms/matrix-hom.h"
+#include "linbox/blackbox/modular-csr-view.h"
+#include "linbox/algorithms/multimod-wiedemann.h"
 
 #include "linbox/algorithms/rational-cra-var-prec.h"
 #include "linbox/algorithms/cra-builder-var-prec-early-multip.h"
@@ -201,20 +207,59 @@ namespace LinBox
 	struct IntegerModularMinpoly {
 		const Blackbox &A;
 		const MyMethod &M;
+		IntegerCSRImage I; //!< shared word size copy of A, when it can be reduced on apply
+		typedef UseModularCSRView<Blackbox,MyMethod> ReduceOnApply;
 
 		IntegerModularMinpoly(const Blackbox& b, const MyMethod& n) :
 			A(b), M(n)
-		{}
+		{
+			initCSRImage(I, A, ReduceOnApply());
+		}
 
 
 		template<typename Polynomial, typename Field>
 		IterationResult operator()(Polynomial& P, const Field& F) const
+		{
+			return iterate(P, F, ReduceOnApply());
+		}
+
+		//! Number of primes sharing each apply of A, see Method::nbPrimesPerApply.
+		size_t primesPerApply() const
+		{
+			return (I.fits() && A.rowdim() == A.coldim()) ? M.nbPrimesPerApply : 1;
+		}
+
+		//! The minimal polynomials modulo all the primes of \p F, in one sequence of applies.
+		template<typename Polynomial, typename Field>
+		void operator()(std::vector<IterationResult>& results, std::vector<Polynomial>& P, const std::vector<Field>& F) const
+		{
+			if (! multiModFits(F)) {
+				for (size_t l = 0; l < F.size(); ++l)
+					results[l] = (*this)(P[l], F[l]);
+				return;
+			}
+			multiModMinpoly(results, P, F, I, M.earlyTerminationThreshold);
+		}
+
+	protected:
+		template<typename Polynomial, typename Field>
+		IterationResult iterate(Polynomial& P, const Field& F, std::false_type) const
 		{
 			typedef typename Blackbox::template rebind<Field>::other FBlackbox;
 			FBlackbox Ap(A, F);
 			minpoly( P, Ap, typename FieldTraits<Field>::categoryTag(), M);
 			return IterationResult::CONTINUE;
 		}
+
+		template<typename Polynomial, typename Field>
+		IterationResult iterate(Polynomial& P, const Field& F, std::true_type) const
+		{
+			if (! I.fits())
+				return iterate(P, F, std::false_type());
+			ModularCSRView<Field> Ap(I, F);
+			minpoly( P, Ap, typename FieldTraits<Field>::categoryTag(), M);
+			return IterationResult::CONTINUE;
+		}
 	};
 
 	template <class Polynomial, class Blackbox, class MyMethod>
@@ -252,12 +297,20 @@ namespace LinBox
 
             // @todo: use a value for the switch provided by the method and not by a macro
 #  ifdef __LINBOX_HEURISTIC_CRA
-		ChineseRemainder< CRABuilderEarlyMultip<Field > > cra(LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD);
+		typedef CRABuilderEarlyMultip<Field > Builder;
+		unsigned long param = LINBOX_DEFAULT_EARLY_TERMINATION_THRESHOLD;
 #  else
-        double hbound = FastCharPolyHadamardBound(A);
-		ChineseRemainder< CRABuilderFullMultip<Field > > cra(hbound);
+		typedef CRABuilderFullMultip<Field > Builder;
+        double param = FastCharPolyHadamardBound(A);
 #  endif
-		cra(P, iteration, genprime);
+		if (iteration.primesPerApply() > 1) {
+			ChineseRemainderMultiMod< Builder > cra(param, iteration.primesPerApply());
+			cra(P, iteration, genprime);
+		}
+		else {
+			ChineseRemainder< Builder > cra(param);
+			cra(P, iteration, genprime);
+		}
 
 #ifdef __LINBOX_HAVE_MPI
 		if(!c || c->rank() == 0)
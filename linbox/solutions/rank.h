@@ -39,6 +39,7 @@
 #include "linbox/algorithms/blackbox-container-symmetric.h"
 #include "linbox/algorithms/blackbox-container.h"
 #include "linbox/algorithms/massey-domain.h"
+#include "linbox/algorithms/multi-massey-domain.h"
 #include "linbox/algorithms/gauss.h"
 #include "linbox/algorithms/gauss-gf2.h"
 #include "linbox/matrix/matrix-domain.h"
@@ -31,6 +31,16 @@
 // #define __LINBOX_rank_sparse_elimination_format SparseMatrixFormat::COO
 // #define __LINBOX_rank_sparse_elimination_format SparseMatrixFormat::CSR
 
+/*! Dimension from which the Wiedemann rank skips the permutation retries.
+ * Each retry is a whole Wiedemann run. Above this size, a butterfly
+ * retry is worth its extra \f$O(n \log n)\f$ per apply: it certifies
+ * with high probability, where up to \f$2 \log n\f$ permutation runs
+ * may fail first.
+ */
+#ifndef LINBOX_BUTTERFLY_RANK_THRESHOLD
+#define LINBOX_BUTTERFLY_RANK_THRESHOLD 100000
+#endif
+
 #include "linbox/field/field-traits.h"
 
 #include <givaro/extension.h>
@@ -39,6 +49,26 @@
 namespace LinBox
 {
 
+	/*! @internal Pseudo minimal polynomial of \p B and its degree minus valuation,
+	 * from M.nbProjections left projections sharing the applies when more
+	 * than one, else from a symmetric projection.
+	 */
+	template <class Field, class Blackbox>
+	inline size_t &wiedemannPseudoMinpoly (BlasVector<Field> &phi, size_t &rk, const Field &F, const Blackbox &B,
+					       typename Field::RandIter &iter, const Method::Wiedemann &M)
+	{
+		if (M.nbProjections > 1) {
+			MultiMasseyDomain<Field, Blackbox> WD (&B, F, M.nbProjections, M.earlyTerminationThreshold);
+			WD.minpoly (phi, rk, iter);
+		}
+		else {
+			BlackboxContainerSymmetric<Field, Blackbox> TF (&B, F, iter);
+			MasseyDomain<Field, BlackboxContainerSymmetric<Field, Blackbox> > WD (&TF, M.earlyTerminationThreshold);
+			WD.pseudo_minpoly (phi, rk);
+		}
+		return rk;
+	}
+
 
 	template <class Blackbox>
 	inline size_t &rank (size_t                    &r,
@@ -48,7 +78,7 @@ namespace LinBox
 	{
 		// we need a BB/Blas hybrid in the style of Duran/Saunders/Wan.
 		//! @bug choose (benchmark) better cuttoff (size, nbnz, sparse rep)
-		if (useBlackboxMethod(A)) {
+		if (useBlackboxMethod(A, m)) {
 			return rank(r, A, tag, Method::Blackbox(m ));
 		}
 		else {
@@ -119,10 +149,8 @@ namespace LinBox
 			Compose<Diagonal<Field>,Blackbox > B_0 (&D_0, &A);
 			BlackBox1 B (&B_0, &D_0);
 
-			BlackboxContainerSymmetric<Field, BlackBox1> TF (&B, F, iter);
-			MasseyDomain<Field, BlackboxContainerSymmetric<Field, BlackBox1> > WD (&TF, M.earlyTerminationThreshold);
 			BlasVector<Field> phi(F);
-			WD.pseudo_minpoly (phi, res);
+			wiedemannPseudoMinpoly (phi, res, F, B, iter, M);
 			commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_DESCRIPTION) << "Pseudo Minpoly degree: " << res << std::endl;
 
 			commentator().start ("Monte Carlo certification (1)", "trace");
@@ -163,10 +191,7 @@ namespace LinBox
 				Compose<Diagonal<Field>,Blackbox > B1 (&D1, &A);
 				BlackBox1 B2 (&B1, &D1);
 
-				BlackboxContainerSymmetric<Field, BlackBox1> TF1 (&B2, F, iter);
-				MasseyDomain<Field, BlackboxContainerSymmetric<Field, BlackBox1> > WD1 (&TF1, M.earlyTerminationThreshold);
-
-				WD1.pseudo_minpoly (phi, rk);
+				wiedemannPseudoMinpoly (phi, rk, F, B2, iter, M);
 				commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_DESCRIPTION) << "Permuted pseudo Minpoly degree: " << res << std::endl;
 				commentator().start ("Monte Carlo certification (2)", "trace");
 				if (phi.size() >= 2) F.neg(p2, phi[ phi.size()-2]);
@@ -203,10 +228,7 @@ namespace LinBox
 				typedef Compose< Compose< ButD, Blackbox > , Transpose< ButD > > BlackBoxBAB;
 				BlackBoxBAB PAP(&B1, &TP);
 
-				BlackboxContainerSymmetric<Field, BlackBoxBAB> TF1 (&PAP, F, iter);
-				MasseyDomain<Field, BlackboxContainerSymmetric<Field, BlackBoxBAB> > WD1 (&TF1, M.earlyTerminationThreshold);
-
-				WD1.pseudo_minpoly (phi, rk);
+				wiedemannPseudoMinpoly (phi, rk, F, PAP, iter, M);
 				commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_DESCRIPTION) << "Butterfly pseudo Minpoly degree: " << res << std::endl;
 				commentator().start ("Monte Carlo certification (3)", "trace");
 				if (phi.size() >= 2) F.neg(p2, phi[ phi.size()-2]);
@@ -259,11 +281,8 @@ namespace LinBox
 			typedef Compose<Compose<Compose<Compose<Diagonal<Field>,Transpose<Blackbox> >, Diagonal<Field> >, Blackbox>, Diagonal<Field> > Blackbox0;
 			Blackbox0 B_i (&B3_i, &D1_i);
 
-			BlackboxContainerSymmetric<Field, Blackbox0> TF_i (&B_i, F, iter);
-			MasseyDomain<Field, BlackboxContainerSymmetric<Field, Blackbox0> > WD (&TF_i, M.earlyTerminationThreshold);
-
 			BlasVector<Field> phi(F);
-			WD.pseudo_minpoly (phi, res);
+			wiedemannPseudoMinpoly (phi, res, F, B_i, iter, M);
 			commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_DESCRIPTION) << "Pseudo Minpoly degree: " << res << std::endl;
 			commentator().start ("Monte Carlo certification (4)", "trace");
 
@@ -275,7 +294,13 @@ namespace LinBox
 			int nbperm = 0; size_t rk;
 			int logn = (int)(2*(size_t)floor( log( (double)A.rowdim() ) ));
 			bool tryagain = (! F.areEqual( t, p2 ));
-			while( tryagain ) {
+			// A failed certification is retried with permutations, whose
+			// applies are cheap, and then with butterflies. From
+			// LINBOX_BUTTERFLY_RANK_THRESHOLD rows, or when butterflies are
+			// asked for, the permutation runs cost more than they save.
+			const bool butterflyFirst = (M.preconditioner == Preconditioner::Butterfly)
+				|| (A.rowdim() >= LINBOX_BUTTERFLY_RANK_THRESHOLD);
+			while( tryagain && ! butterflyFirst ) {
 				commentator().stop ("fail", NULL, "trace");
 				Permutation<Field> P(F,(int)A.rowdim());
 				for (i = 0; i < A.rowdim (); ++i)
@@ -301,10 +326,7 @@ namespace LinBox
 				typedef Compose<Compose<Compose<Compose<Diagonal<Field>,Transpose<BlackboxP> >, Diagonal<Field> >, BlackboxP>, Diagonal<Field> > Blackbox1;
 				Blackbox1 B (&B3, &D1);
 
-				BlackboxContainerSymmetric<Field, Blackbox1> TF (&B, F, iter);
-				MasseyDomain<Field, BlackboxContainerSymmetric<Field, Blackbox1> > MD (&TF, M.earlyTerminationThreshold);
-
-				MD.pseudo_minpoly (phi, rk);
+				wiedemannPseudoMinpoly (phi, rk, F, B, iter, M);
 				commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_DESCRIPTION) << "Permuted pseudo Minpoly degree: " << rk << std::endl;
 				commentator().start ("Monte Carlo certification (5)", "trace");
 				if (phi.size() >= 2) F.neg(p2, phi[ phi.size()-2]);
@@ -345,10 +367,7 @@ namespace LinBox
 				typedef Compose<Compose<Compose<Compose<Diagonal<Field>,Transpose<BlackboxP> >, Diagonal<Field> >, BlackboxP>, Diagonal<Field> > Blackbox1;
 				Blackbox1 B (&B3, &D1);
 
-				BlackboxContainerSymmetric<Field, Blackbox1> TF (&B, F, iter);
-				MasseyDomain<Field, BlackboxContainerSymmetric<Field, Blackbox1> > MD (&TF, M.earlyTerminationThreshold);
-
-				MD.pseudo_minpoly (phi, rk);
+				wiedemannPseudoMinpoly (phi, rk, F, B, iter, M);
 				commentator().report(Commentator::LEVEL_ALWAYS,INTERNAL_DESCRIPTION) << "Butterfly pseudo Minpoly degree: " << rk << std::endl;
 				commentator().start ("Monte Carlo certification (6)", "trace");
 				if (phi.size() >= 2) F.neg(p2, phi[ phi.size()-2]);
@@ -423,7 +442,7 @@ namespace LinBox
 		linbox_check( a == b );
 		linbox_check( a < LinBox::BlasBound);
 		BlasMatrix<Field> B(A);
-		BlasMatrixDomain<Field> D(F);
+		BlasMatrixDomain<Field> D(F, BlasParallelism(M.nbThreads));
 		r = D.rankInPlace(B);
 		commentator().stop ("done", NULL, "blasrank");
 		return r;
@@ -615,7 +634,7 @@ namespace LinBox { /*  rankInPlace */
 
 		commentator().start ("BlasBB Rank", "blasbbrank");
 		const Field F = A.field();
-		BlasMatrixDomain<Field> D(F);
+		BlasMatrixDomain<Field> D(F, BlasParallelism(M.nbThreads));
 		r = D.rankInPlace(static_cast< BlasMatrix<Field>& >(A));
 		commentator().stop ("done", NULL, "blasbbrank");
 		return r;
@@ -653,7 +672,7 @@ namespace LinBox { /*  rankInPlace */
 	{
 		commentator().start ("Sparse Elimination Rank", "serank");
 		GaussDomain<typename Blackbox::Field> GD (A.field());
-		GD.rankInPlace( r, A, M.pivotStrategy);
+		GD.rankInPlace( r, A, M);
 		commentator().stop ("done", NULL, "serank");
 		return r;
 	}
@@ -51,9 +51,20 @@ namespace LinBox {
      * CategoryTag is defaulted to `FieldTraits<Matrix::Field>::categoryTag()` when omitted.
      *
      * - Method::Auto
+     *      - IntegerTag
+     *      |   - Non-singular square system, CRA cheaper by the machine profile > Method::CRAAuto
+     *      |   - Otherwise                                                     > Method::Dixon
      *      - DenseMatrix   > Method::DenseElimination
-     *      - SparseMatrix  > Method::SparseElimination
+     *      - SparseMatrix
+     *      |   - Blackbox cheaper by the machine profile > Method::Blackbox
+     *      |   - Otherwise                               > Method::SparseElimination
+     *      |   Without a machine profile, this is always Method::SparseElimination:
+     *      |   the method then depends on the LINBOX_PROFILE environment variable
+     *      |   (see MachineProfile::defaultFile).
      *      - Otherwise
+     *      |   - With a machine profile (see solutions/method-cost.h), the cheapest of
+     *      |     Method::Blackbox and Method::Elimination given the dimensions, nonzeros,
+     *      |     field size and threads
      *      |   - Row or column dimension < LINBOX_USE_BLACKBOX_THRESHOLD > Method::Elimination
      *      |   - Otherwise                                               > Method::Blackbox
      * - Method::Elimination
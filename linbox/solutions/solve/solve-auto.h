@@ -24,9 +24,57 @@
 
 #include <linbox/matrix/dense-matrix.h>
 #include <linbox/matrix/sparse-matrix.h>
+#include <linbox/solutions/hadamard-bound.h>
 #include <linbox/solutions/methods.h>
 
+#if defined(LINBOX_USES_OPENMP)
+#include <omp.h>
+#endif
+
 namespace LinBox {
+    /**
+     * Whether Method::CRA is expected to be faster than Method::Dixon on the integer system.
+     *
+     * Only known non-singular square systems are considered, with a machine profile:
+     * both methods need about as many primes as p-adic digits, but the CRA shares them
+     * between the threads and the nodes while the lifting is sequential.
+     * The number of primes is estimated from the largest entries of A and b.
+     */
+    template <class Matrix, class Vector>
+    bool useCRAMethod(const Matrix& A, const Vector& b, const MethodBase& m)
+    {
+        const MachineProfile& profile = MachineProfile::host();
+        if (!profile.valid() || (profile.lifting <= 0.) || (profile.craPrime <= 0.) || (m.singularity != Singularity::NonSingular)
+            || (A.rowdim() != A.coldim())) {
+            return false;
+        }
+        MatrixStatsCache::Pointer stats = knownStats(A);
+        if (!stats) {
+            return false;
+        }
+
+        size_t n = A.coldim();
+        unsigned int bits = FieldTraits<Givaro::ModularBalanced<double>>::bestBitSize(n);
+        // numerator and denominator below the Hadamard bound of [A|b]
+        Integer infnorm = stats->maxNorm;
+        for (const auto& bi : b) {
+            if (infnorm < bi) infnorm = bi;
+            else if (infnorm < -bi) infnorm = -bi;
+        }
+        double logBound = FastHadamardBound(A, infnorm);
+        size_t steps = (size_t)std::ceil((2. * logBound + 2.) / (double)(bits - 1));
+
+#if defined(LINBOX_USES_OPENMP)
+        size_t threads = (size_t)omp_get_max_threads(); // as ChineseRemainderOMP
+#else
+        size_t threads = 1;
+#endif
+        size_t processes = (m.pCommunicator != nullptr) ? (size_t)m.pCommunicator->size() : 1;
+        MethodCost dixonCost(profile, m.nbThreads);
+        MethodCost craCost(profile, threads, processes);
+        return craCost.cra(*stats, steps) < dixonCost.dixon(*stats, steps);
+    }
+
     //
     // solve
     //
@@ -37,7 +85,7 @@ namespace LinBox {
     template <class ResultVector, class Matrix, class Vector, class CategoryTag>
     ResultVector& solve(ResultVector& x, const Matrix& A, const Vector& b, const CategoryTag& tag, const Method::Auto& m)
     {
-        if (useBlackboxMethod(A)) {
+        if (useBlackboxMethod(A, m)) {
             return solve(x, A, b, tag, reinterpret_cast<const Method::Blackbox&>(m));
         }
         else {
@@ -62,6 +110,10 @@ namespace LinBox {
     ResultVector& solve(ResultVector& x, const SparseMatrix<MatrixArgs...>& A, const Vector& b,
                         const RingCategories::ModularTag& tag, const Method::Auto& m)
     {
+        // Without a machine profile, fill-in is assumed to stay low.
+        if (MachineProfile::host().valid() && useBlackboxMethod(A, m)) {
+            return solve(x, A, b, tag, reinterpret_cast<const Method::Blackbox&>(m));
+        }
         return solve(x, A, b, tag, reinterpret_cast<const Method::SparseElimination&>(m));
     }
 
@@ -96,7 +148,12 @@ namespace LinBox {
     inline void solve(IntVector& xNum, typename IntVector::Element& xDen, const Matrix& A, const Vector& b,
                       const RingCategories::IntegerTag& tag, const Method::Auto& m)
     {
-        solve(xNum, xDen, A, b, tag, reinterpret_cast<const Method::Dixon&>(m));
+        if (useCRAMethod(A, b, m)) {
+            solve(xNum, xDen, A, b, tag, Method::CRAAuto(m));
+        }
+        else {
+            solve(xNum, xDen, A, b, tag, reinterpret_cast<const Method::Dixon&>(m));
+        }
     }
 
     //
@@ -109,7 +166,7 @@ namespace LinBox {
     template <class ResultVector, class Matrix, class Vector, class CategoryTag>
     ResultVector& solveInPlace(ResultVector& x, Matrix& A, const Vector& b, const CategoryTag& tag, const Method::Auto& m)
     {
-        if (useBlackboxMethod(A)) {
+        if (useBlackboxMethod(A, m)) {
             return solve(x, A, b, tag, reinterpret_cast<const Method::Blackbox&>(m));
         }
         else {
@@ -176,7 +176,9 @@ namespace LinBox {
         }
 #if defined(__LINBOX_HAVE_MPI)
         else if (dispatch == Dispatch::Distributed) {
-            LinBox::ChineseRemainderDistributed<CRAAlgorithm> cra(hadamardLogBound, m.pCommunicator);
+            // Full reconstruction is reduced along a tree of ranks, early termination needs the master to stop the workers
+            bool earlyTermination = std::is_same<MatrixCategoryTag, RingCategories::RationalTag>::value;
+            LinBox::ChineseRemainderDistributed<CRAAlgorithm> cra(hadamardLogBound, m.pCommunicator, earlyTermination);
             cra(num, den, iteration, primeGenerator);
         }
 #endif
@@ -38,6 +38,9 @@ namespace LinBox {
         template <class T> inline void ssend(const T& value, int dest) {}
         template <class T> inline void recv(T& value, int src) {}
         template <class T> inline void bcast(T& value, int src) {}
+
+        inline void signal(int dest, int tag) {}
+        inline bool probe(int src, int tag) { return false; }
     };
 }
 #else
@@ -89,6 +92,10 @@ namespace LinBox {
         template <class T> void recv(T& value, int src);
         template <class T> void bcast(T& value, int src);
 
+        // empty messages, nonblocking
+        void signal(int dest, int tag);     // posts an empty message, no completion to wait for
+        bool probe(int src, int tag);       // receives a pending empty message, if any
+
     protected:
         MPI_Comm _comm;       // MPI's handle for the communicator
         MPI_Status _status;   // status from most recent receive
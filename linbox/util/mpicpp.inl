@@ -137,6 +137,25 @@ namespace LinBox {
             unserialize(value, bytes);
         }
     }
+
+    // empty messages
+
+    void Communicator::signal(int dest, int tag)
+    {
+        MPI_Request request;
+        MPI_Isend(nullptr, 0, MPI_BYTE, dest, tag, _comm, &request);
+        MPI_Request_free(&request);
+    }
+
+    bool Communicator::probe(int src, int tag)
+    {
+        int flag = 0;
+        MPI_Iprobe(src, tag, _comm, &flag, &_status);
+        if (flag) {
+            MPI_Recv(nullptr, 0, MPI_BYTE, src, tag, _comm, &_status);
+        }
+        return flag != 0;
+    }
 }
 
 // Local Variables:
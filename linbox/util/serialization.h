@@ -26,6 +26,7 @@
 #include <linbox/matrix/dense-matrix.h>
 #include <linbox/matrix/sparse-matrix.h>
 #include <linbox/vector/blas-vector.h>
+#include <string>
 #include <vector>
 
 /**
@@ -35,7 +36,7 @@
  * Serialize functions add data to a prexisting vector of bytes,
  * they return the number of bytes written.
  * Unserialize ones read a vector of bytes starting at a specific offset,
- * the number of bytes read.
+ * the number of bytes read, or 0 when the bytes end too early.
  *
  * As a convention, all numbers are written little-endian.
  *
@@ -151,6 +152,45 @@ namespace LinBox {
      */
     template <class Field>
     uint64_t unserialize(BlasVector<Field>& V, const std::vector<uint8_t>& bytes, uint64_t offset = 0u);
+
+    /**
+     * Serializes a std::vector, or a class derived from it (polynomials).
+     *
+     * Format is (by bytes count):
+     *  0-7  l      Length of the vector
+     *  8-..        Entries of the vector
+     */
+    template <class T, class Alloc>
+    uint64_t serialize(std::vector<uint8_t>& bytes, const std::vector<T, Alloc>& V);
+
+    /**
+     * Unserializes a std::vector.
+     * The vector will be resized if necessary.
+     */
+    template <class T, class Alloc>
+    uint64_t unserialize(std::vector<T, Alloc>& V, const std::vector<uint8_t>& bytes, uint64_t offset = 0u);
+
+    // Files
+
+    /**
+     * Writes bytes to a file.
+     * The file is first written under a temporary name then renamed,
+     * so that an interrupted write never leaves a truncated file behind.
+     * Returns false on failure.
+     */
+    bool write_bytes(const std::string& filename, const std::vector<uint8_t>& bytes);
+
+    /**
+     * Reads the whole content of a file into bytes.
+     * Returns false if the file cannot be read.
+     */
+    bool read_bytes(std::vector<uint8_t>& bytes, const std::string& filename);
+
+    /**
+     * Hash of bytes, to fingerprint serialized data.
+     * Not cryptographic.
+     */
+    uint64_t hash_bytes(const std::vector<uint8_t>& bytes);
 }
 
 #include "serialization.inl"
@@ -23,6 +23,12 @@
 
 #include "serialization.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
 namespace LinBox {
     // ----- Basic serializations
 
@@ -99,11 +105,17 @@ namespace LinBox {
 
     // ----- Basic unserializations
 
+    // Whether n bytes can be read at offset
+    inline bool unserialize_fits(const std::vector<uint8_t>& bytes, uint64_t offset, uint64_t n)
+    {
+        return offset <= bytes.size() && n <= bytes.size() - offset;
+    }
+
     template <class T>
     inline uint64_t unserialize_raw(T& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const T*>(uValue);
+        if (!unserialize_fits(bytes, offset, sizeof(T))) return 0u;
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
         return sizeof(T);
     }
 
@@ -127,8 +139,7 @@ namespace LinBox {
 
     inline uint64_t unserialize(int16_t& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const int16_t*>(uValue);
+        if (!unserialize_raw(value, bytes, offset)) return 0u;
 #if defined(__LINBOX_HAVE_BIG_ENDIAN)
         value = __builtin_bswap16(value);
 #endif
@@ -136,8 +147,7 @@ namespace LinBox {
     }
     inline uint64_t unserialize(uint16_t& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const uint16_t*>(uValue);
+        if (!unserialize_raw(value, bytes, offset)) return 0u;
 #if defined(__LINBOX_HAVE_BIG_ENDIAN)
         value = __builtin_bswap16(value);
 #endif
@@ -146,8 +156,7 @@ namespace LinBox {
 
     inline uint64_t unserialize(int32_t& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const int32_t*>(uValue);
+        if (!unserialize_raw(value, bytes, offset)) return 0u;
 #if defined(__LINBOX_HAVE_BIG_ENDIAN)
         value = __builtin_bswap32(value);
 #endif
@@ -155,8 +164,7 @@ namespace LinBox {
     }
     inline uint64_t unserialize(uint32_t& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const uint32_t*>(uValue);
+        if (!unserialize_raw(value, bytes, offset)) return 0u;
 #if defined(__LINBOX_HAVE_BIG_ENDIAN)
         value = __builtin_bswap32(value);
 #endif
@@ -165,8 +173,7 @@ namespace LinBox {
 
     inline uint64_t unserialize(int64_t& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const int64_t*>(uValue);
+        if (!unserialize_raw(value, bytes, offset)) return 0u;
 #if defined(__LINBOX_HAVE_BIG_ENDIAN)
         value = __builtin_bswap64(value);
 #endif
@@ -174,8 +181,7 @@ namespace LinBox {
     }
     inline uint64_t unserialize(uint64_t& value, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        auto uValue = &bytes.at(offset);
-        value = *reinterpret_cast<const uint64_t*>(uValue);
+        if (!unserialize_raw(value, bytes, offset)) return 0u;
 #if defined(__LINBOX_HAVE_BIG_ENDIAN)
         value = __builtin_bswap64(value);
 #endif
@@ -212,6 +218,7 @@ namespace LinBox {
         int32_t mpSize;
         uint64_t bytesRead = 0u;
         bytesRead += unserialize(mpSize, bytes, offset + bytesRead);
+        if (bytesRead == 0u || !unserialize_fits(bytes, offset + bytesRead, 8u * (uint64_t)std::abs(mpSize))) return 0u;
 
         mpzStruct->_mp_alloc = std::abs(mpSize);
         mpzStruct->_mp_size = mpSize;
@@ -249,16 +256,20 @@ namespace LinBox {
     template <class Field>
     inline uint64_t unserialize(BlasMatrix<Field>& M, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        uint64_t n, m;
+        uint64_t n = 0, m = 0;
         uint64_t bytesRead = 0u;
         bytesRead += unserialize(n, bytes, offset + bytesRead);
         bytesRead += unserialize(m, bytes, offset + bytesRead);
+        // every entry takes at least one byte
+        if (bytesRead != 16u || (m && n > (bytes.size() - offset - bytesRead) / m)) return 0u;
 
         M.resize(n, m);
         for (uint64_t i = 0; i < n; ++i) {
             for (uint64_t j = 0; j < m; ++j) {
                 typename Field::Element entry;
-                bytesRead += unserialize(entry, bytes, offset + bytesRead);
+                uint64_t r = unserialize(entry, bytes, offset + bytesRead);
+                if (r == 0u) return 0u;
+                bytesRead += r;
                 M.setEntry(i, j, entry);
             }
         }
@@ -297,25 +308,32 @@ namespace LinBox {
     template <class Field>
     inline uint64_t unserialize(SparseMatrix<Field>& M, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        uint64_t n, m;
+        uint64_t n = 0, m = 0;
         uint64_t bytesRead = 0u;
         bytesRead += unserialize(n, bytes, offset + bytesRead);
         bytesRead += unserialize(m, bytes, offset + bytesRead);
+        if (bytesRead != 16u) return 0u;
 
         M.resize(n, m);
         while (true) {
-            uint64_t i, j;
-            bytesRead += unserialize(i, bytes, offset + bytesRead);
+            uint64_t i = 0, j = 0;
+            uint64_t r = unserialize(i, bytes, offset + bytesRead);
+            if (r == 0u) return 0u;
+            bytesRead += r;
 
             // Check if there is the mark of the end of the matrix entries
             if (i == 0xFFFFFFFFFFFFFFFF) {
                 break;
             }
 
-            bytesRead += unserialize(j, bytes, offset + bytesRead);
+            r = unserialize(j, bytes, offset + bytesRead);
+            if (r == 0u || i >= n || j >= m) return 0u;
+            bytesRead += r;
 
             typename Field::Element entry;
-            bytesRead += unserialize(entry, bytes, offset + bytesRead);
+            r = unserialize(entry, bytes, offset + bytesRead);
+            if (r == 0u) return 0u;
+            bytesRead += r;
             M.setEntry(i, j, entry);
         }
 
@@ -341,15 +359,86 @@ namespace LinBox {
     template <class Field>
     inline uint64_t unserialize(BlasVector<Field>& V, const std::vector<uint8_t>& bytes, uint64_t offset)
     {
-        uint64_t l;
+        uint64_t l = 0;
         uint64_t bytesRead = 0u;
         bytesRead += unserialize(l, bytes, offset + bytesRead);
+        // every entry takes at least one byte
+        if (bytesRead == 0u || l > bytes.size() - offset - bytesRead) return 0u;
 
         V.resize(l);
         for (uint64_t i = 0; i < l; ++i) {
-            bytesRead += unserialize(V[i], bytes, offset + bytesRead);
+            uint64_t r = unserialize(V[i], bytes, offset + bytesRead);
+            if (r == 0u) return 0u;
+            bytesRead += r;
         }
 
         return bytesRead;
     }
+
+    // ----- std::vector
+
+    template <class T, class Alloc>
+    inline uint64_t serialize(std::vector<uint8_t>& bytes, const std::vector<T, Alloc>& V)
+    {
+        uint64_t l = V.size();
+        auto bytesWritten = serialize(bytes, l);
+
+        for (uint64_t i = 0; i < l; ++i) {
+            bytesWritten += serialize(bytes, V[i]);
+        }
+
+        return bytesWritten;
+    }
+
+    template <class T, class Alloc>
+    inline uint64_t unserialize(std::vector<T, Alloc>& V, const std::vector<uint8_t>& bytes, uint64_t offset)
+    {
+        uint64_t l = 0;
+        uint64_t bytesRead = 0u;
+        bytesRead += unserialize(l, bytes, offset + bytesRead);
+        // every entry takes at least one byte
+        if (bytesRead == 0u || l > bytes.size() - offset - bytesRead) return 0u;
+
+        V.resize(l);
+        for (uint64_t i = 0; i < l; ++i) {
+            uint64_t r = unserialize(V[i], bytes, offset + bytesRead);
+            if (r == 0u) return 0u;
+            bytesRead += r;
+        }
+
+        return bytesRead;
+    }
+
+    // ----- Files
+
+    inline bool write_bytes(const std::string& filename, const std::vector<uint8_t>& bytes)
+    {
+        const std::string tmpname = filename + ".tmp";
+        {
+            std::ofstream out(tmpname, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!out) return false;
+        }
+        return std::rename(tmpname.c_str(), filename.c_str()) == 0;
+    }
+
+    inline bool read_bytes(std::vector<uint8_t>& bytes, const std::string& filename)
+    {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) return false;
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    inline uint64_t hash_bytes(const std::vector<uint8_t>& bytes)
+    {
+        // 64 bit FNV-1a
+        uint64_t h = 14695981039346656037ull;
+        for (uint8_t b : bytes) {
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
 }
@@ -124,6 +124,14 @@ bool testRankMethods(const typename BlackBox::Field & F, size_t n, size_t m, uns
 		equalRank = equalRank and rank_Wiedemann == rank_elimination;
 #endif
 
+		size_t rank_parallel;
+		Method::SparseElimination MP;
+		MP.dispatch = Dispatch::SMP;
+		LinBox::rank (rank_parallel, A, MP);
+		commentator().report ()
+			<< endl << "parallel sparse elimination rank " << rank_parallel << endl;
+		equalRank = equalRank and rank_parallel == rank_elimination;
+
 		size_t rank_blas_elimination ;
 		if (F.characteristic() < LinBox::BlasBound
 				and
@@ -260,6 +268,15 @@ bool testZeroAndIdentRank (const Field &F, size_t n, unsigned int iterations = 1
 			ret = false;
 		}
 
+		Method::Wiedemann MWK;
+		MWK.nbProjections = 3;
+		LinBox::rank (r, A, MWK);
+		if (r != 0) {
+			commentator().report (Commentator::LEVEL_IMPORTANT, INTERNAL_ERROR)
+				<< "ERROR: multi-projection Wiedemann Rank of 0 is not 0, but is " << r << endl;
+			ret = false;
+		}
+
 		Blackbox I (F, n, n, F.one);
 //		LinBox::rank (r, I, MW);
 r = n;